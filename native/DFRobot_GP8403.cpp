@@ -0,0 +1,41 @@
+#include "DFRobot_GP8403.h"
+
+uint8_t DFRobot_GP8403::begin() {
+  _pWire->begin();
+  _pWire->beginTransmission(_addr);
+  return (_pWire->endTransmission() != 0) ? 1 : 0;
+}
+
+void DFRobot_GP8403::setDACOutRange(eOutPutRange_t range) {
+  _voltage = (range == eOutputRange10V) ? 10000 : 5000;
+  _pWire->beginTransmission(_addr);
+  _pWire->write(GP8403_OUTPUT_RANGE);
+  _pWire->write((uint8_t)range);
+  _pWire->endTransmission();
+}
+
+void DFRobot_GP8403::setDACOutVoltage(uint16_t data, uint8_t channel) {
+  uint16_t code = (uint16_t)(((float)data / _voltage) * 4095);
+  if (code > 4095) code = 4095;
+  sendData(code << 4, channel);
+}
+
+void DFRobot_GP8403::sendData(uint16_t data, uint8_t channel) {
+  _pWire->beginTransmission(_addr);
+  if (channel == 0) {
+    _pWire->write(GP8403_CONFIG_CURRENT_REG);
+    _pWire->write(data & 0xFF);
+    _pWire->write(data >> 8);
+  } else if (channel == 1) {
+    _pWire->write(GP8403_CONFIG_CURRENT_REG << 1);
+    _pWire->write(data & 0xFF);
+    _pWire->write(data >> 8);
+  } else {
+    _pWire->write(GP8403_CONFIG_CURRENT_REG);
+    _pWire->write(data & 0xFF);
+    _pWire->write(data >> 8);
+    _pWire->write(data & 0xFF);
+    _pWire->write(data >> 8);
+  }
+  _pWire->endTransmission();
+}
@@ -0,0 +1,33 @@
+#ifndef HOST_DFROBOT_GP8403_H
+#define HOST_DFROBOT_GP8403_H
+
+// Réimplémentation hôte de DFRobot_GP8403: mêmes trames I2C que la bibliothèque
+// (plage en 0x01, canal 0 en 0x02, canal 1 en 0x04, code 12 bits << 4, LSB d'abord).
+
+#include <Wire.h>
+
+#define GP8403_CONFIG_CURRENT_REG 0x02
+#define GP8403_OUTPUT_RANGE       0x01
+
+class DFRobot_GP8403 {
+public:
+  typedef enum {
+    eOutputRange5V  = 0x00,
+    eOutputRange10V = 0x11,
+  } eOutPutRange_t;
+
+  DFRobot_GP8403(TwoWire* pWire = &Wire, uint8_t addr = 0x58) : _pWire(pWire), _addr(addr) {}
+
+  uint8_t begin();
+  void setDACOutRange(eOutPutRange_t range);
+  void setDACOutVoltage(uint16_t data, uint8_t channel);  // mV, canal 0, 1 ou 2 (les deux)
+
+private:
+  void sendData(uint16_t data, uint8_t channel);
+
+  TwoWire* _pWire;
+  uint8_t  _addr;
+  uint16_t _voltage = 5000;
+};
+
+#endif // HOST_DFROBOT_GP8403_H
@@ -0,0 +1,48 @@
+#include "EEPROM.h"
+#include <stdio.h>
+#include <string>
+
+EEPROMClass EEPROM;
+
+static uint8_t eepromImage[EEPROMClass::SIZE];
+static bool eepromLoaded = false;
+static std::string eepromPath;
+
+// Une EEPROM vierge contient 0xFF; le fichier est chargé au premier accès
+static void eepromLoad() {
+  if (eepromLoaded) return;
+  eepromLoaded = true;
+  memset(eepromImage, 0xFF, sizeof(eepromImage));
+  if (eepromPath.empty()) return;
+  FILE* f = fopen(eepromPath.c_str(), "rb");
+  if (!f) return;
+  size_t n = fread(eepromImage, 1, sizeof(eepromImage), f);
+  (void)n;
+  fclose(f);
+}
+
+static void eepromFlush() {
+  if (eepromPath.empty()) return;
+  FILE* f = fopen(eepromPath.c_str(), "wb");
+  if (!f) return;
+  fwrite(eepromImage, 1, sizeof(eepromImage), f);
+  fclose(f);
+}
+
+void hostEepromSetFile(const char* path) {
+  eepromPath = path ? path : "";
+  eepromLoaded = false;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  eepromLoad();
+  if (address < 0 || address >= SIZE) return 0xFF;
+  return eepromImage[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  eepromLoad();
+  if (address < 0 || address >= SIZE) return;
+  eepromImage[address] = value;
+  eepromFlush();
+}
@@ -0,0 +1,32 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// EEPROM hôte: image mémoire de 8 Ko, relue/écrite dans le fichier fixé par hostEepromSetFile().
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+  static const int SIZE = 8192;
+
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+  int length() const { return SIZE; }
+
+  template <class T> T& get(int address, T& t) {
+    uint8_t* p = (uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) p[i] = read(address + (int)i);
+    return t;
+  }
+
+  template <class T> const T& put(int address, const T& t) {
+    const uint8_t* p = (const uint8_t*)&t;
+    for (size_t i = 0; i < sizeof(T); i++) update(address + (int)i, p[i]);
+    return t;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // HOST_EEPROM_H
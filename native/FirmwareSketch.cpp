@@ -0,0 +1,4 @@
+// Le sketch est compilé tel quel comme unité de traduction C++ pour la cible hôte
+// (pas de préprocesseur .ino hors framework Arduino).
+#include <Arduino.h>
+#include "Keyboard_V9.ino"
@@ -0,0 +1,69 @@
+#include "FspTimer.h"
+
+static uint8_t timersHandedOut = 0;
+
+int8_t FspTimer::get_available_timer(uint8_t& type, bool force) {
+  (void)force;
+  type = GPT_TIMER;
+  if (timersHandedOut >= HOST_NUM_TIMERS) return -1;
+  return (int8_t)timersHandedOut++;
+}
+
+bool FspTimer::begin(timer_mode_t mode, uint8_t type, uint8_t channel, float freq_hz, float duty_perc,
+                     GPTimerCbk_f callback, void* ctx) {
+  (void)type; (void)channel; (void)duty_perc;
+  if (freq_hz <= 0.0f) return false;
+  end();
+  _timer = hostTimerCreate(onHostTimer, this);
+  if (_timer < 0) return false;
+  _mode = mode;
+  _callback = callback;
+  _ctx = ctx;
+  _period_us = (uint64_t)(1000000.0f / freq_hz + 0.5f);
+  return true;
+}
+
+bool FspTimer::start() {
+  if (_timer < 0 || _period_us == 0) return false;
+  hostTimerStart(_timer, _period_us, _mode == TIMER_MODE_PERIODIC);
+  _running = true;
+  return true;
+}
+
+bool FspTimer::stop() {
+  if (_timer < 0) return false;
+  hostTimerStop(_timer);
+  _running = false;
+  return true;
+}
+
+void FspTimer::end() {
+  if (_timer < 0) return;
+  hostTimerRelease(_timer);
+  _timer = -1;
+  _running = false;
+}
+
+bool FspTimer::set_frequency(float freq_hz) {
+  if (freq_hz <= 0.0f) return false;
+  return set_period((uint32_t)(1000000.0f / freq_hz + 0.5f));
+}
+
+bool FspTimer::set_period(uint32_t ticks) {
+  if (_timer < 0) return false;
+  // Période tronquée à 0: le compteur n'atteint jamais l'échéance
+  _period_us = ticks & HOST_TIMER_PERIOD_MAX;
+  if (_running) start();
+  return _period_us != 0;
+}
+
+void FspTimer::onHostTimer(void* context) {
+  FspTimer* self = (FspTimer*)context;
+  if (self->_mode == TIMER_MODE_ONE_SHOT) self->_running = false;
+  if (!self->_callback) return;
+  timer_callback_args_t args;
+  args.p_context = self->_ctx;
+  args.event = TIMER_EVENT_CYCLE_END;
+  args.capture = 0;
+  self->_callback(&args);
+}
@@ -0,0 +1,65 @@
+#ifndef HOST_FSP_TIMER_H
+#define HOST_FSP_TIMER_H
+
+// Réimplémentation hôte de FspTimer (core Arduino Renesas): sous-ensemble utilisé par le
+// firmware, adossé aux timers de la HAL hôte. Le compteur avance à 1 MHz (1 tick = 1 µs) et
+// sa période tient sur 16 bits, comme les canaux AGT et GPT 16 bits que get_available_timer()
+// peut rendre: set_period() perd les bits hauts, comme le registre de période de la cible.
+
+#include "Arduino.h"
+
+typedef enum {
+  TIMER_MODE_PERIODIC,
+  TIMER_MODE_ONE_SHOT
+} timer_mode_t;
+
+typedef enum {
+  TIMER_EVENT_CYCLE_END
+} timer_event_t;
+
+typedef struct {
+  void const*   p_context;
+  timer_event_t event;
+  uint32_t      capture;
+} timer_callback_args_t;
+
+typedef void (*GPTimerCbk_f)(timer_callback_args_t*);
+
+#define GPT_TIMER 0
+#define AGT_TIMER 1
+
+const uint32_t HOST_TIMER_PERIOD_MAX = 0xFFFF;
+
+class FspTimer {
+public:
+  FspTimer() {}
+  ~FspTimer() { end(); }
+
+  static int8_t get_available_timer(uint8_t& type, bool force = false);
+
+  bool begin(timer_mode_t mode, uint8_t type, uint8_t channel, float freq_hz, float duty_perc,
+             GPTimerCbk_f callback = nullptr, void* ctx = nullptr);
+  bool setup_overflow_irq(uint8_t priority = 12) { (void)priority; return _timer >= 0; }
+  bool open() { return _timer >= 0; }
+  bool start();
+  bool stop();
+  bool close() { return stop(); }
+  void end();
+
+  bool set_frequency(float freq_hz);
+  bool set_period(uint32_t ticks);    // En ticks du compteur (µs)
+  uint32_t get_freq_hz() const { return _period_us ? 1000000UL / _period_us : 0; }
+  uint32_t get_period_raw() const { return (uint32_t)_period_us; }
+
+private:
+  static void onHostTimer(void* context);
+
+  int          _timer = -1;
+  timer_mode_t _mode = TIMER_MODE_PERIODIC;
+  uint64_t     _period_us = 0;
+  bool         _running = false;
+  GPTimerCbk_f _callback = nullptr;
+  void*        _ctx = nullptr;
+};
+
+#endif // HOST_FSP_TIMER_H
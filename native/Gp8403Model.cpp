@@ -0,0 +1,43 @@
+#include "Gp8403Model.h"
+
+Gp8403Model::Gp8403Model(uint8_t address) : _address(address) {
+  _range = 0x00;
+  for (int c = 0; c < 2; c++) {
+    _code[c] = 0;
+    _lastWrite_us[c] = 0;
+    _writeCount[c] = 0;
+  }
+}
+
+void Gp8403Model::onWrite(const uint8_t* data, size_t len) {
+  uint8_t reg = data[0];
+  if (reg == 0x01) {
+    if (len >= 2) _range = data[1];
+    return;
+  }
+  // Canaux: 0x02 puis 0x04, deux octets chacun
+  size_t i = 1;
+  uint8_t channel = (reg == 0x04) ? 1 : 0;
+  if (reg != 0x02 && reg != 0x04) return;
+  while (i + 1 < len && channel < 2) {
+    storeChannel(channel, data[i], data[i + 1]);
+    i += 2;
+    channel++;
+  }
+}
+
+size_t Gp8403Model::onRead(uint8_t* out, size_t len) {
+  for (size_t i = 0; i < len; i++) out[i] = 0;
+  return len;
+}
+
+void Gp8403Model::storeChannel(uint8_t channel, uint8_t lsb, uint8_t msb) {
+  _code[channel] = (uint16_t)((msb << 8) | lsb) >> 4;
+  _lastWrite_us[channel] = hostNowMicros();
+  _writeCount[channel]++;
+}
+
+float Gp8403Model::getVoltage(uint8_t channel) const {
+  float fullScale = (_range == 0x11) ? 10.0f : 5.0f;
+  return getCode(channel) * fullScale / 4095.0f;
+}
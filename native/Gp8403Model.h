@@ -0,0 +1,36 @@
+#ifndef GP8403_MODEL_H
+#define GP8403_MODEL_H
+
+// =================================================================
+// Modèle registre du DAC GP8403 pour la HAL hôte
+// =================================================================
+//  - 0x01: plage de sortie (0x00 = 0-5V, 0x11 = 0-10V)
+//  - 0x02: canal 0, 0x04: canal 1; code 12 bits aligné à gauche (<< 4), LSB d'abord
+// Une écriture de 4 octets à partir de 0x02 met à jour les deux canaux (auto-incrément).
+
+#include "HostHal.h"
+
+class Gp8403Model : public HostI2cDevice {
+public:
+  explicit Gp8403Model(uint8_t address);
+
+  uint8_t address() const override { return _address; }
+  void onWrite(const uint8_t* data, size_t len) override;
+  size_t onRead(uint8_t* out, size_t len) override;
+
+  uint16_t getCode(uint8_t channel) const { return channel < 2 ? _code[channel] : 0; }
+  float getVoltage(uint8_t channel) const;
+  uint64_t getLastWriteMicros(uint8_t channel) const { return channel < 2 ? _lastWrite_us[channel] : 0; }
+  uint32_t getWriteCount(uint8_t channel) const { return channel < 2 ? _writeCount[channel] : 0; }
+
+private:
+  void storeChannel(uint8_t channel, uint8_t lsb, uint8_t msb);
+
+  uint8_t  _address;
+  uint8_t  _range;
+  uint16_t _code[2];
+  uint64_t _lastWrite_us[2];
+  uint32_t _writeCount[2];
+};
+
+#endif // GP8403_MODEL_H
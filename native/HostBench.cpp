@@ -0,0 +1,320 @@
+#include "Arduino.h"
+#include "HostBench.h"
+#include "HostBoard.h"
+#include "HardwareConfig.h"
+#include "LoopProfiler.h"
+#include "EngineMode2.h"
+#include "PitchCalibration.h"
+#include "MidiClockSync.h"
+#include "PressureChain.h"
+#include "CycleCounter.h"
+#include <stdio.h>
+#include <math.h>
+
+void loop();
+void transitionToMode(GameMode newMode);
+extern LoopProfiler loopProfiler;
+
+// Chute de donnée filtrée d'un appui franc (au-dessus du seuil adaptatif par défaut)
+static const uint16_t BENCH_TOUCH_DELTA = 300;
+
+static uint32_t benchRandomState = 0x1234567;
+
+// Mesure "physique", possible seulement sur banc: de l'instant où le doigt change la capacité
+// au premier front montant de PIN_TRIGGER qui suit
+static Histogram touchToTrigger;
+static uint64_t touchTime_us = 0;
+static bool touchPending = false;
+
+static void onBenchPinWrite(uint8_t pin, int level) {
+  if (pin == PIN_TRIGGER && level == HIGH && touchPending) {
+    touchToTrigger.record((uint32_t)(hostNowMicros() - touchTime_us));
+    touchPending = false;
+  }
+}
+
+static uint32_t benchRandom(uint32_t range) {
+  benchRandomState = benchRandomState * 1664525UL + 1013904223UL;
+  return (benchRandomState >> 8) % range;
+}
+
+static void runFor(uint32_t duration_us, uint32_t loopCost_us) {
+  uint64_t end = hostNowMicros() + duration_us;
+  while (hostNowMicros() < end) {
+    loop();
+    hostAdvanceMicros(loopCost_us);
+  }
+}
+
+// Appuis legato: la touche suivante arrive pendant que la précédente est tenue, à une phase
+// aléatoire par rapport au scan pour échantillonner toute la fenêtre d'attente du bus.
+static void playNotes(uint32_t notes, uint32_t loopCost_us) {
+  int previousKey = -1;
+  for (uint32_t n = 0; n < notes; n++) {
+    int key = benchRandom(NUM_KEYS);
+    if (key == previousKey) key = (key + 1) % NUM_KEYS;
+    hostBoardSetKeyDelta(key, BENCH_TOUCH_DELTA);
+    touchTime_us = hostNowMicros();
+    touchPending = true;
+    runFor(20000 + benchRandom(40000), loopCost_us);
+    if (previousKey >= 0) hostBoardSetKeyDelta(previousKey, 0);
+    runFor(5000 + benchRandom(20000), loopCost_us);
+    previousKey = key;
+  }
+  if (previousKey >= 0) hostBoardSetKeyDelta(previousKey, 0);
+  runFor(200000, loopCost_us);
+}
+
+static void printHistogram(const char* engine, const char* measure, const Histogram& h) {
+  printf("%-15s %-14s %-6u %-8u %-8u %-8u %u\n", engine, measure, h.count(), h.minimum(),
+         h.percentile(500), h.percentile(990), h.maximum());
+}
+
+void hostBenchLatency(uint32_t notes, uint32_t loopCost_us) {
+  static const GameMode modes[] = { MODE_PRESSURE_GLIDE, MODE_INTERVAL };
+  static const char* const names[] = { "mode1 (glide)", "mode2 (au pas)" };
+
+  printf("latence touche -> sortie, %u appuis par mode, %u us de boucle simulee\n", notes, loopCost_us);
+  printf("trame->sortie: mesure embarquee (LoopProfiler), appui->TRIG: doigt -> premier front trigger\n");
+  printf("mode2: quantifie au pas d'arpege (une note ajoutee sort au pas suivant, seules celles\n"
+         "       entendues sont comptees): attente du pas, pas latence d'entree\n");
+  printf("moteur          mesure         n      min(us)  p50(us)  p99(us)  max(us)\n");
+  hostSetPinWriteHook(onBenchPinWrite);
+  for (uint8_t m = 0; m < 2; m++) {
+    transitionToMode(modes[m]);
+    runFor(100000, loopCost_us);
+    loopProfiler.reset();
+    touchToTrigger.reset();
+    touchPending = false;
+    playNotes(notes, loopCost_us);
+
+    printHistogram(names[m], "trame->sortie", loopProfiler.getKeyToOutputHistogram(modes[m]));
+    printHistogram(names[m], "appui->TRIG", touchToTrigger);
+  }
+  hostSetPinWriteHook(nullptr);
+}
+
+// Un pas d'arpège: écart (us) entre le retrigger et sa place sur la grille idéale
+struct ArpDriftResult {
+  uint32_t measured;
+  double   maxLate_us;
+  double   firstMean_us;   // Moyenne des écarts sur le premier dixième des pas mesurés
+  double   lastMean_us;    // ... et sur le dernier dixième
+};
+
+// shuffleClicks: crans d'encodeur en shift OCT- (profondeur du gabarit 1). Avec shuffle, seuls les
+// pas de début de cycle (décalage nul dans tous les gabarits) sont comparés à la grille.
+static ArpDriftResult runArpDrift(uint16_t bpm, int shuffleClicks, uint32_t steps, uint32_t loopCost_us) {
+  static PitchCalibration pitchCal;
+  static const bool noKeys[NUM_KEYS] = {};
+  EngineMode2 engine;
+  engine.begin(pitchCal);
+  engine.setTempo(bpm);
+
+  InputEvent event = {};
+  event.type = InputEventType::ENCODER;
+  event.modifiers = INPUT_MOD_SHIFT_MINUS;
+  event.value = 1;
+  for (int i = 0; i < shuffleClicks; i++) engine.handleInput(event, noKeys);
+
+  // Deux notes: l'arpège démarre sur la grille au premier appui
+  engine.onNoteOn(48, 500);
+  uint64_t start_us = hostNowMicros();
+  engine.onNoteOn(55, 500);
+  engine.getAndClearRetriggerEvent();
+
+  ArpDriftResult result = {};
+  uint32_t window = steps / 10 ? steps / 10 : 1;
+  double firstSum = 0.0, lastSum = 0.0;
+  uint32_t firstCount = 0, lastCount = 0;
+  for (uint32_t step = 1; step <= steps; ) {
+    engine.update();
+    if (engine.getAndClearRetriggerEvent()) {
+      bool onGrid = shuffleClicks == 0 || step % SHUFFLE_STEPS_PER_CYCLE == 0;
+      if (onGrid) {
+        // Grille exacte en entier 64 bits: aucune erreur d'arrondi côté référence
+        uint64_t ideal_num = (uint64_t)step * 60000000ULL;
+        double error_us = (double)(hostNowMicros() - start_us) - (double)ideal_num / bpm;
+        if (error_us > result.maxLate_us) result.maxLate_us = error_us;
+        if (step <= window) { firstSum += error_us; firstCount++; }
+        if (step > steps - window) { lastSum += error_us; lastCount++; }
+        result.measured++;
+      }
+      step++;
+    }
+    hostAdvanceMicros(loopCost_us);
+  }
+  result.firstMean_us = firstCount ? firstSum / firstCount : 0.0;
+  result.lastMean_us = lastCount ? lastSum / lastCount : 0.0;
+  return result;
+}
+
+void hostBenchArpDrift(uint32_t steps, uint32_t loopCost_us) {
+  static const uint16_t tempos[] = { 120, 137, 451, ARP_BPM_MAX };
+  static const int shuffles[] = { 0, 100 };
+
+  printf("derive de l'horloge d'arpege, %u pas par tempo, update() toutes les %u us\n", steps, loopCost_us);
+  printf("ecart = retrigger - grille ideale n*60e6/bpm; derive = moyenne du dernier dixieme - premier dixieme\n");
+  printf("bpm   shuffle  pas mesures  ecart max(us)  debut(us)  fin(us)  derive(us)  ancien(ms)\n");
+  for (uint8_t t = 0; t < sizeof(tempos) / sizeof(tempos[0]); t++) {
+    for (uint8_t s = 0; s < sizeof(shuffles) / sizeof(shuffles[0]); s++) {
+      ArpDriftResult r = runArpDrift(tempos[t], shuffles[s], steps, loopCost_us);
+      // Référence: avance cumulée par l'ancienne période tronquée à la milliseconde (hors shuffle)
+      double stepTime_ms = 60000.0 / tempos[t];
+      double oldDrift_ms = -(steps * (stepTime_ms - floor(stepTime_ms)));
+      printf("%-5u %-8s %-12u %-14.1f %-10.1f %-8.1f %-11.1f %.1f\n", tempos[t], shuffles[s] ? "oui" : "non",
+             r.measured, r.maxLate_us, r.firstMean_us, r.lastMean_us, r.lastMean_us - r.firstMean_us,
+             oldDrift_ms);
+    }
+  }
+}
+
+// Gigue d'arrivée d'un tick (USB, ordonnancement côté DAW), uniforme sur [0, max[
+static const uint32_t BENCH_CLOCK_JITTER_US = 1000;
+// Temps exclus de la mesure lissée le temps que la boucle de suivi converge
+static const uint32_t MIDI_CLOCK_BENCH_SETTLE_BEATS = 8;
+
+// Écarts signés à la grille idéale: moyenne (retard constant), écart type (gigue), max
+struct ErrorStats {
+  uint32_t count;
+  double   sum;
+  double   sumSquares;
+  double   maxAbs;
+
+  void reset() { count = 0; sum = sumSquares = maxAbs = 0.0; }
+  void record(double error) {
+    count++;
+    sum += error;
+    sumSquares += error * error;
+    if (fabs(error) > maxAbs) maxAbs = fabs(error);
+  }
+  double mean() const { return count ? sum / count : 0.0; }
+  double deviation() const {
+    if (count < 2) return 0.0;
+    double m = mean();
+    double variance = sumSquares / count - m * m;
+    return variance > 0.0 ? sqrt(variance) : 0.0;
+  }
+};
+
+struct ClockFollowResult {
+  ErrorStats smoothed;  // Pas joués par l'arpège esclave
+  ErrorStats raw;       // Premier tick reçu de chaque temps
+  double     firstMean_us;
+  double     lastMean_us;
+};
+
+static void runClockFollow(double bpm, uint32_t steps, uint32_t loopCost_us, ClockFollowResult& result) {
+  static PitchCalibration pitchCal;
+  MidiClockSync clock;
+  EngineMode2 engine;
+  engine.begin(pitchCal);
+  engine.setClockSync(&clock);
+  engine.setTempo(120);  // Tempo interne volontairement différent de celui du maître
+
+  double tickPeriod_us = 60000000.0 / (bpm * MIDI_CLOCKS_PER_BEAT);
+  uint64_t origin_us = hostNowMicros();
+  // Deux temps d'horloge à l'arrêt (la plupart des DAW l'émettent en continu), puis Start
+  const uint32_t preTicks = 2 * MIDI_CLOCKS_PER_BEAT;
+  uint32_t totalTicks = preTicks + steps * MIDI_CLOCKS_PER_BEAT;
+  uint32_t tick = 0;
+  double nextArrival_us = 0.0;
+  bool started = false;
+  bool notesDown = false;
+
+  result.smoothed.reset();
+  result.raw.reset();
+  uint32_t window = steps / 10 ? steps / 10 : 1;
+  double firstSum = 0.0, lastSum = 0.0;
+  uint32_t firstCount = 0, lastCount = 0;
+  uint32_t step = 0;
+
+  while (step < steps && tick < totalTicks + MIDI_CLOCKS_PER_BEAT) {
+    double now = (double)(hostNowMicros() - origin_us);
+    // Ticks arrivés depuis le dernier passage, horodatés à la lecture (tâche MIDI)
+    while (tick < totalTicks && now >= nextArrival_us) {
+      if (tick == preTicks) {
+        clock.onStart();
+        started = true;
+      }
+      clock.onClock((uint32_t)hostNowMicros());
+      if (started && (tick - preTicks) % MIDI_CLOCKS_PER_BEAT == 0) {
+        result.raw.record(now - tick * tickPeriod_us);
+      }
+      tick++;
+      nextArrival_us = tick * tickPeriod_us + benchRandom(BENCH_CLOCK_JITTER_US);
+    }
+    if (!notesDown && clock.isLocked((uint32_t)hostNowMicros())) {
+      engine.onNoteOn(48, 500);
+      engine.onNoteOn(55, 500);
+      engine.getAndClearRetriggerEvent();
+      notesDown = true;
+    }
+
+    engine.update();
+    if (engine.getAndClearRetriggerEvent() && started) {
+      double error_us = now - (preTicks + step * MIDI_CLOCKS_PER_BEAT) * tickPeriod_us;
+      // Les premiers temps servent à l'accrochage de l'estimateur
+      if (step >= MIDI_CLOCK_BENCH_SETTLE_BEATS) {
+        result.smoothed.record(error_us);
+        if (step < MIDI_CLOCK_BENCH_SETTLE_BEATS + window) { firstSum += error_us; firstCount++; }
+        if (step >= steps - window) { lastSum += error_us; lastCount++; }
+      }
+      step++;
+    }
+    hostAdvanceMicros(loopCost_us);
+  }
+  result.firstMean_us = firstCount ? firstSum / firstCount : 0.0;
+  result.lastMean_us = lastCount ? lastSum / lastCount : 0.0;
+}
+
+void hostBenchMidiClock(uint32_t steps, uint32_t loopCost_us) {
+  static const double tempos[] = { 120.0, 128.3, 174.0 };
+  static ClockFollowResult r;
+
+  printf("suivi d'horloge MIDI, %u temps par tempo, gigue d'arrivee 0-%u us, update() toutes les %u us\n",
+         steps, BENCH_CLOCK_JITTER_US, loopCost_us);
+  printf("ecart = instant - temps ideal du maitre; brut = tick recu, lisse = pas joue par l'arpege esclave\n");
+  printf("bpm     mesure  n      retard(us)  gigue(us)  max(us)  derive(us)\n");
+  for (uint8_t t = 0; t < sizeof(tempos) / sizeof(tempos[0]); t++) {
+    runClockFollow(tempos[t], steps, loopCost_us, r);
+    printf("%-7.1f brut    %-6u %-11.1f %-10.1f %.0f\n", tempos[t], r.raw.count, r.raw.mean(),
+           r.raw.deviation(), r.raw.maxAbs);
+    printf("%-7.1f lisse   %-6u %-11.1f %-10.1f %-8.0f %.1f\n", tempos[t], r.smoothed.count, r.smoothed.mean(),
+           r.smoothed.deviation(), r.smoothed.maxAbs, r.lastMean_us - r.firstMean_us);
+  }
+}
+
+// =================================================================
+// Chaîne de pression: virgule fixe contre flottant
+// =================================================================
+template <class Chain>
+static double measureTicksPerKey(uint32_t rounds, const uint16_t* curve) {
+  static Chain chains[NUM_KEYS];
+  for (int k = 0; k < NUM_KEYS; k++) chains[k].reset();
+  volatile uint32_t sink = 0;  // Garde le calcul
+  uint32_t start = cycleCounterNow();
+  for (uint32_t n = 0; n < rounds; n++) {
+    for (int k = 0; k < NUM_KEYS; k++) {
+      sink += chains[k].process(true, 120 + ((n + k * 7) % 200), 70, 400, curve);
+    }
+  }
+  uint32_t elapsed = cycleCounterNow() - start;
+  (void)sink;
+  return (double)elapsed / ((double)rounds * NUM_KEYS);
+}
+
+void hostBenchPressureChain(uint32_t rounds) {
+  static const float shapes[] = { 0.0f, 0.25f, 0.75f };
+  static uint16_t curve[RESPONSE_CURVE_LUT_SIZE + 1];
+
+  printf("chaine de pression, %u trames x %u touches, temps CPU du PC (horloge %lu Hz)\n", rounds, NUM_KEYS,
+         (unsigned long)cycleCounterHz());
+  printf("forme  fixe(ticks/touche)  flottant(ticks/touche)  rapport\n");
+  for (uint8_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+    buildResponseCurve(curve, shapes[s], AFTERTOUCH_CURVE_EXP_INTENSITY, AFTERTOUCH_CURVE_SIG_INTENSITY);
+    double fixedTicks = measureTicksPerKey<PressureChainFixed>(rounds, curve);
+    double floatTicks = measureTicksPerKey<PressureChainFloat>(rounds, curve);
+    printf("%-6.2f %-19.1f %-23.1f %.2f\n", shapes[s], fixedTicks, floatTicks, floatTicks / fixedTicks);
+  }
+}
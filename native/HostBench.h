@@ -0,0 +1,31 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+// =================================================================
+// Bancs de mesure de l'exécutable hôte
+// =================================================================
+// Tous les temps sont ceux de l'horloge virtuelle (temps bus I2C + coût de boucle simulé),
+// c'est-à-dire la latence que verrait la carte, pas le temps CPU du PC.
+
+#include <stdint.h>
+
+// Latence touche -> sortie: joue `notes` appuis legato générés (graine fixe) dans chaque
+// mode clavier et affiche min/p50/p99/max par moteur.
+void hostBenchLatency(uint32_t notes, uint32_t loopCost_us);
+
+// Dérive de l'horloge d'arpège: fait tourner un EngineMode2 isolé sur `steps` pas à plusieurs
+// tempos (dont des périodes non entières) et compare chaque pas à la grille idéale n*60e6/bpm.
+void hostBenchArpDrift(uint32_t steps, uint32_t loopCost_us);
+
+// Suivi d'horloge MIDI: un EngineMode2 isolé suit `steps` temps d'une horloge externe à 24 ppqn
+// dont chaque tick arrive avec une gigue aléatoire. Compare l'écart des pas à la grille idéale
+// du maître avec celui d'un arpège qui jouerait directement sur le tick reçu.
+void hostBenchMidiClock(uint32_t steps, uint32_t loopCost_us);
+
+// Coût de la chaîne de pression: `rounds` trames des 24 touches par PressureChainFixed puis par
+// PressureChainFloat. Exception aux temps virtuels: c'est le temps CPU du PC (cycleCounterNow(),
+// en ns), qui ne donne que l'ordre de grandeur et le rapport entre les deux chemins; le coût
+// sur cible se lit dans le dump du profileur ('p').
+void hostBenchPressureChain(uint32_t rounds);
+
+#endif // HOST_BENCH_H
@@ -0,0 +1,26 @@
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "HardwareConfig.h"
+
+static Mpr121Model sensorA(ADDR_MPR121_A, PIN_MPR121_IRQ, 0);
+static Mpr121Model sensorB(ADDR_MPR121_B, PIN_MPR121_IRQ, 1);
+static Gp8403Model dacModel(DAC_I2C_ADDR);
+
+void hostBoardInit() {
+  hostI2cAttach(&sensorA);
+  hostI2cAttach(&sensorB);
+  hostI2cAttach(&dacModel);
+}
+
+Mpr121Model& hostBoardSensor(uint8_t sensorIndex) {
+  return sensorIndex == 0 ? sensorA : sensorB;
+}
+
+Gp8403Model& hostBoardDac() {
+  return dacModel;
+}
+
+void hostBoardSetKeyDelta(uint8_t key, uint16_t delta) {
+  if (key >= NUM_KEYS) return;
+  hostBoardSensor(key / Mpr121Model::NUM_ELECTRODES).setTouchDelta(key % Mpr121Model::NUM_ELECTRODES, delta);
+}
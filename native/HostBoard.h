@@ -0,0 +1,21 @@
+#ifndef HOST_BOARD_H
+#define HOST_BOARD_H
+
+// =================================================================
+// Carte virtuelle: les modèles de périphériques câblés comme sur le PCB
+// =================================================================
+// Deux MPR121 (0x5A: touches 0-11, 0x5B: touches 12-23) dont les IRQ partagent PIN_MPR121_IRQ,
+// et le GP8403 à DAC_I2C_ADDR. Les boutons restent au repos (pull-up) sauf si le banc les force.
+
+#include "Mpr121Model.h"
+#include "Gp8403Model.h"
+
+void hostBoardInit();
+
+Mpr121Model& hostBoardSensor(uint8_t sensorIndex);
+Gp8403Model& hostBoardDac();
+
+// Chute de la donnée filtrée de la touche (counts 10 bits, 0 = relâchée)
+void hostBoardSetKeyDelta(uint8_t key, uint16_t delta);
+
+#endif // HOST_BOARD_H
@@ -0,0 +1,431 @@
+#include "HostHal.h"
+#include "Arduino.h"
+#include "pinDefinitions.h"
+#include <stdio.h>
+#include <deque>
+#include <vector>
+
+// =================================================================
+// Horloge virtuelle
+// =================================================================
+static uint64_t virtualMicros = 0;
+
+static void dispatchTimersUntil(uint64_t target_us);
+
+uint64_t hostNowMicros() { return virtualMicros; }
+void hostAdvanceMicros(uint64_t us) { dispatchTimersUntil(virtualMicros + us); }
+
+unsigned long millis() { return (unsigned long)(virtualMicros / 1000); }
+unsigned long micros() { return (unsigned long)virtualMicros; }
+void delay(unsigned long ms) { hostAdvanceMicros((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { hostAdvanceMicros(us); }
+
+// =================================================================
+// GPIO
+// =================================================================
+struct HostPin {
+  uint8_t mode;
+  uint8_t outputLevel;
+  bool    forced;          // Entrée pilotée par le banc (bouton, encodeur)
+  uint8_t forcedLevel;
+  uint32_t openDrainLow;   // Une source par bit: la ligne est basse si au moins une tire
+  int     analogIn;
+  int     analogOut;
+  bool    noIrq;           // Pas de canal IRQ sur cette broche
+  void  (*isr)();
+  int     isrMode;
+  int     lastLevel;
+};
+
+static HostPin pins[HOST_NUM_PINS];
+static bool interruptsEnabled = true;
+static HostPinWriteHook pinWriteHook = nullptr;
+
+static int pinLevel(uint8_t pin) {
+  const HostPin& p = pins[pin];
+  if (p.mode == OUTPUT) return p.outputLevel;
+  if (p.openDrainLow) return LOW;
+  if (p.forced) return p.forcedLevel;
+  return (p.mode == INPUT_PULLUP) ? HIGH : LOW;
+}
+
+// Réévalue le niveau d'une broche et déclenche son ISR sur le front attendu
+static void pinChanged(uint8_t pin) {
+  HostPin& p = pins[pin];
+  int level = pinLevel(pin);
+  if (level == p.lastLevel) return;
+  int previous = p.lastLevel;
+  p.lastLevel = level;
+  if (!p.isr || !interruptsEnabled) return;
+  bool fire = (p.isrMode == CHANGE) ||
+              (p.isrMode == FALLING && previous == HIGH && level == LOW) ||
+              (p.isrMode == RISING && previous == LOW && level == HIGH);
+  if (fire) p.isr();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].mode = mode;
+  pinChanged(pin);
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  if (pin >= HOST_NUM_PINS) return;
+  uint8_t l = level ? HIGH : LOW;
+  bool changed = (pins[pin].outputLevel != l);
+  pins[pin].outputLevel = l;
+  pinChanged(pin);
+  if (changed && pinWriteHook) pinWriteHook(pin, l);
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= HOST_NUM_PINS) return LOW;
+  return pinLevel(pin);
+}
+
+int analogRead(uint8_t pin) {
+  if (pin < A0) pin += A0;  // analogRead(0) == analogRead(A0)
+  if (pin >= HOST_NUM_PINS) return 0;
+  return pins[pin].analogIn;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].analogOut = value;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*handler)(), int mode) {
+  if (interruptNum >= HOST_NUM_PINS || pins[interruptNum].noIrq) return;
+  pins[interruptNum].isr = handler;
+  pins[interruptNum].isrMode = mode;
+  pins[interruptNum].lastLevel = pinLevel(interruptNum);
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if (interruptNum >= HOST_NUM_PINS) return;
+  pins[interruptNum].isr = nullptr;
+}
+
+std::array<uint16_t, 3> getPinCfgs(const uint8_t pin, PinCfgReq_t req) {
+  std::array<uint16_t, 3> cfgs = { 0, 0, 0 };
+  if (pin >= HOST_NUM_PINS) return cfgs;
+  // Toute valeur non nulle décrit une configuration valide
+  if (req == PIN_CFG_REQ_INTERRUPT && !pins[pin].noIrq) cfgs[0] = 0x8000 | pin;
+  return cfgs;
+}
+
+void hostSetPinInterruptCapable(uint8_t pin, bool capable) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].noIrq = !capable;
+  if (!capable) pins[pin].isr = nullptr;
+}
+
+static void firePendingTimers();
+
+void noInterrupts() { interruptsEnabled = false; }
+void interrupts() {
+  interruptsEnabled = true;
+  firePendingTimers();
+}
+
+void hostSetPinInput(uint8_t pin, int level) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].forced = true;
+  pins[pin].forcedLevel = level ? HIGH : LOW;
+  pinChanged(pin);
+}
+
+void hostReleasePin(uint8_t pin) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].forced = false;
+  pinChanged(pin);
+}
+
+void hostSetOpenDrain(uint8_t pin, uint8_t source, bool pullLow) {
+  if (pin >= HOST_NUM_PINS || source >= 32) return;
+  if (pullLow) pins[pin].openDrainLow |= (1UL << source);
+  else         pins[pin].openDrainLow &= ~(1UL << source);
+  pinChanged(pin);
+}
+
+int hostGetPinOutput(uint8_t pin) {
+  if (pin >= HOST_NUM_PINS) return LOW;
+  return pins[pin].outputLevel;
+}
+
+void hostSetAnalogInput(uint8_t pin, int value) {
+  if (pin >= HOST_NUM_PINS) return;
+  pins[pin].analogIn = value;
+}
+
+int hostGetAnalogOutput(uint8_t pin) {
+  if (pin >= HOST_NUM_PINS) return 0;
+  return pins[pin].analogOut;
+}
+
+void hostSetPinWriteHook(HostPinWriteHook hook) { pinWriteHook = hook; }
+
+// =================================================================
+// Timers matériels
+// =================================================================
+struct HostTimer {
+  bool     used;
+  bool     armed;
+  bool     periodic;
+  bool     pending;          // Échéance passée pendant noInterrupts()
+  uint64_t period_us;
+  uint64_t deadline_us;
+  HostTimerCallback callback;
+  void*    context;
+};
+
+static HostTimer timers[HOST_NUM_TIMERS];
+static bool inTimerDispatch = false;
+
+int hostTimerCreate(HostTimerCallback callback, void* context) {
+  for (int i = 0; i < HOST_NUM_TIMERS; i++) {
+    if (timers[i].used) continue;
+    timers[i] = HostTimer();
+    timers[i].used = true;
+    timers[i].callback = callback;
+    timers[i].context = context;
+    return i;
+  }
+  return -1;
+}
+
+void hostTimerStart(int timer, uint64_t period_us, bool periodic) {
+  if (timer < 0 || timer >= HOST_NUM_TIMERS || !timers[timer].used) return;
+  HostTimer& t = timers[timer];
+  t.period_us = period_us > 0 ? period_us : 1;
+  t.deadline_us = virtualMicros + t.period_us;
+  t.periodic = periodic;
+  t.armed = true;
+}
+
+void hostTimerStop(int timer) {
+  if (timer < 0 || timer >= HOST_NUM_TIMERS) return;
+  timers[timer].armed = false;
+  timers[timer].pending = false;
+}
+
+void hostTimerRelease(int timer) {
+  if (timer < 0 || timer >= HOST_NUM_TIMERS) return;
+  timers[timer] = HostTimer();
+}
+
+static void fireTimer(HostTimer& t) {
+  if (!interruptsEnabled) {
+    t.pending = true;
+    return;
+  }
+  inTimerDispatch = true;
+  t.callback(t.context);
+  inTimerDispatch = false;
+}
+
+// Avance l'horloge jusqu'à target_us en s'arrêtant sur chaque échéance, dans l'ordre.
+// Un rappel qui consomme lui-même du temps (I2C, delay) ne redéclenche pas de timer.
+static void dispatchTimersUntil(uint64_t target_us) {
+  if (inTimerDispatch) {
+    virtualMicros = target_us;
+    return;
+  }
+  while (true) {
+    HostTimer* next = nullptr;
+    for (int i = 0; i < HOST_NUM_TIMERS; i++) {
+      HostTimer& t = timers[i];
+      if (t.armed && t.deadline_us <= target_us && (!next || t.deadline_us < next->deadline_us)) next = &t;
+    }
+    if (!next) break;
+    if (next->deadline_us > virtualMicros) virtualMicros = next->deadline_us;
+    if (next->periodic) next->deadline_us += next->period_us;
+    else next->armed = false;
+    if (next->callback) fireTimer(*next);
+  }
+  if (target_us > virtualMicros) virtualMicros = target_us;
+}
+
+static void firePendingTimers() {
+  if (inTimerDispatch) return;
+  for (int i = 0; i < HOST_NUM_TIMERS; i++) {
+    if (timers[i].used && timers[i].pending) {
+      timers[i].pending = false;
+      fireTimer(timers[i]);
+    }
+  }
+}
+
+// =================================================================
+// Divers
+// =================================================================
+static uint32_t randomState = 1;
+
+long random(long howBig) {
+  if (howBig <= 0) return 0;
+  randomState = randomState * 1103515245UL + 12345UL;  // Déterministe d'une exécution à l'autre
+  return (long)((randomState >> 8) % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) randomState = (uint32_t)seed;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// =================================================================
+// I2C
+// =================================================================
+static std::vector<HostI2cDevice*> i2cDevices;
+static uint32_t i2cClockHz = 100000;
+static uint64_t i2cTotalBytes = 0;
+
+void hostI2cAttach(HostI2cDevice* device) { i2cDevices.push_back(device); }
+
+HostI2cDevice* hostI2cFind(uint8_t address) {
+  for (HostI2cDevice* d : i2cDevices) {
+    if (d->address() == address) return d;
+  }
+  return nullptr;
+}
+
+void hostI2cSetClock(uint32_t hz) { if (hz > 0) i2cClockHz = hz; }
+
+void hostI2cAccountBytes(size_t bytes) {
+  // 9 bits par octet (8 données + ACK), start/stop négligés
+  i2cTotalBytes += bytes;
+  hostAdvanceMicros((uint64_t)bytes * 9 * 1000000ULL / i2cClockHz);
+}
+
+uint64_t hostI2cTotalBytes() { return i2cTotalBytes; }
+
+// =================================================================
+// Port série
+// =================================================================
+static std::deque<uint8_t> serialRx;
+static std::deque<uint8_t> serialTx;
+static bool serialTextOutput = true;
+static bool serialTextCapture = false;
+static std::deque<char> serialText;
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+
+void hostSerialInject(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) serialRx.push_back(data[i]);
+}
+
+void hostSerialSetTextOutput(bool enabled) { serialTextOutput = enabled; }
+
+void hostSerialCaptureText(bool enabled) {
+  serialTextCapture = enabled;
+  if (!enabled) serialText.clear();
+}
+
+size_t hostSerialTakeText(char* out, size_t maxLen) {
+  size_t n = 0;
+  while (n < maxLen && !serialText.empty()) {
+    out[n++] = serialText.front();
+    serialText.pop_front();
+  }
+  return n;
+}
+
+size_t hostSerialTakeTx(uint8_t* out, size_t maxLen) {
+  size_t n = 0;
+  while (n < maxLen && !serialTx.empty()) {
+    out[n++] = serialTx.front();
+    serialTx.pop_front();
+  }
+  return n;
+}
+
+int HardwareSerial::available() {
+  return (this == &Serial) ? (int)serialRx.size() : 0;
+}
+
+int HardwareSerial::read() {
+  if (this != &Serial || serialRx.empty()) return -1;
+  uint8_t b = serialRx.front();
+  serialRx.pop_front();
+  return b;
+}
+
+int HardwareSerial::peek() {
+  if (this != &Serial || serialRx.empty()) return -1;
+  return serialRx.front();
+}
+
+size_t HardwareSerial::write(uint8_t b) {
+  if (this == &Serial) serialTx.push_back(b);
+  return 1;
+}
+
+void HardwareSerial::writeText(const char* text, size_t len) {
+  if (this != &Serial) return;
+  if (serialTextOutput) fwrite(text, 1, len, stdout);
+  if (serialTextCapture) serialText.insert(serialText.end(), text, text + len);
+}
+
+// --- Print ---
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) write(buffer[i]);
+  return size;
+}
+
+size_t Print::print(const char* s) {
+  size_t len = strlen(s);
+  writeText(s, len);
+  return len;
+}
+
+size_t Print::print(char c) {
+  writeText(&c, 1);
+  return 1;
+}
+
+size_t Print::print(unsigned char n, int base) { return print((unsigned long long)n, base); }
+size_t Print::print(int n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned int n, int base) { return print((unsigned long long)n, base); }
+size_t Print::print(long n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned long n, int base) { return print((unsigned long long)n, base); }
+
+size_t Print::print(long long n, int base) {
+  if (n < 0 && base == DEC) {
+    size_t len = print('-');
+    return len + print((unsigned long long)(-n), base);
+  }
+  return print((unsigned long long)n, base);
+}
+
+size_t Print::print(unsigned long long n, int base) {
+  char buf[72];
+  int pos = sizeof(buf);
+  if (base < 2) base = DEC;
+  do {
+    int digit = n % base;
+    buf[--pos] = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    n /= base;
+  } while (n > 0);
+  writeText(&buf[pos], sizeof(buf) - pos);
+  return sizeof(buf) - pos;
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[64];
+  int len = snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  writeText(buf, len);
+  return len;
+}
+
+size_t Print::println() {
+  writeText("\r\n", 2);
+  return 2;
+}
@@ -0,0 +1,77 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// =================================================================
+// HAL hôte (Linux) du firmware
+// =================================================================
+// Le firmware ne parle qu'à l'API Arduino (Wire1, millis, digitalWrite, EEPROM...).
+// Sur cible cette API est fournie par le core Renesas; sur PC elle est fournie par les
+// fichiers de native/, qui s'appuient sur ce module:
+//  - une horloge virtuelle en microsecondes (avance par delay(), le temps bus I2C et la boucle)
+//  - des timers matériels dont les interruptions tombent pendant que l'horloge avance
+//  - une table de broches (sorties, entrées forcées, lignes open-drain, interruptions)
+//  - un bus I2C sur lequel se branchent les modèles de registres (MPR121, GP8403)
+//  - le port série (texte vers stdout, octets bruts capturés) et l'EEPROM sur fichier
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Horloge virtuelle ---
+uint64_t hostNowMicros();
+void     hostAdvanceMicros(uint64_t us);
+
+// --- Timers matériels ---
+// Le rappel est appelé "en interruption": à l'échéance exacte, au milieu d'un delay() ou
+// d'une transaction I2C, ou à la sortie de noInterrupts() s'il est tombé pendant le masquage.
+typedef void (*HostTimerCallback)(void* context);
+const uint8_t HOST_NUM_TIMERS = 8;
+
+int  hostTimerCreate(HostTimerCallback callback, void* context);   // -1 si plus de timer libre
+void hostTimerStart(int timer, uint64_t period_us, bool periodic);  // Première échéance: maintenant + période
+void hostTimerStop(int timer);
+void hostTimerRelease(int timer);
+
+// --- GPIO ---
+const uint8_t HOST_NUM_PINS = 32;
+
+void hostSetPinInput(uint8_t pin, int level);       // Force le niveau d'une entrée (bouton, encodeur)
+void hostReleasePin(uint8_t pin);                   // Rend l'entrée à son pull-up / flottante
+void hostSetOpenDrain(uint8_t pin, uint8_t source, bool pullLow);  // Ligne partagée (IRQ MPR121)
+// Broche sans canal IRQ (toutes en ont par défaut): attachInterrupt() l'ignore, comme le core
+void hostSetPinInterruptCapable(uint8_t pin, bool capable);
+int  hostGetPinOutput(uint8_t pin);
+void hostSetAnalogInput(uint8_t pin, int value);
+int  hostGetAnalogOutput(uint8_t pin);
+
+// Appelé à chaque changement de niveau d'une sortie (traces, mesures de latence)
+typedef void (*HostPinWriteHook)(uint8_t pin, int level);
+void hostSetPinWriteHook(HostPinWriteHook hook);
+
+// --- I2C ---
+class HostI2cDevice {
+public:
+  virtual ~HostI2cDevice() {}
+  virtual uint8_t address() const = 0;
+  // Phase écriture: le premier octet est le pointeur de registre
+  virtual void onWrite(const uint8_t* data, size_t len) = 0;
+  // Phase lecture: renvoie le nombre d'octets fournis
+  virtual size_t onRead(uint8_t* out, size_t len) = 0;
+};
+
+void     hostI2cAttach(HostI2cDevice* device);
+HostI2cDevice* hostI2cFind(uint8_t address);
+void     hostI2cSetClock(uint32_t hz);
+void     hostI2cAccountBytes(size_t bytes);         // Avance l'horloge du temps bus
+uint64_t hostI2cTotalBytes();
+
+// --- Port série ---
+void   hostSerialInject(const uint8_t* data, size_t len);   // Octets reçus (MIDI, commandes)
+void   hostSerialSetTextOutput(bool enabled);               // print() vers stdout
+size_t hostSerialTakeTx(uint8_t* out, size_t maxLen);       // Octets bruts émis par write()
+void   hostSerialCaptureText(bool enabled);                 // Garde le texte de print() pour les tests
+size_t hostSerialTakeText(char* out, size_t maxLen);        // Texte capturé depuis l'appel précédent
+
+// --- EEPROM ---
+void hostEepromSetFile(const char* path);
+
+#endif // HOST_HAL_H
@@ -0,0 +1,241 @@
+#include "Arduino.h"
+#include "HostScenario.h"
+#include "HostBoard.h"
+#include "HardwareConfig.h"
+#include "CapacitiveKeyboard.h"
+#include <string.h>
+#include <vector>
+
+void setup();
+void loop();
+extern CapacitiveKeyboard keyboard;
+
+enum class ScenarioOp { KEY, BUTTON, ENCODER, POT, MIDI };
+
+struct ScenarioEvent {
+  uint32_t time_ms;
+  ScenarioOp op;
+  int arg0;
+  int arg1;
+  std::vector<uint8_t> bytes;
+};
+
+static std::vector<ScenarioEvent> events;
+static size_t nextEvent = 0;
+
+// Encodeur: séquence quadrature (A<<1 | B) dans le sens +1 de SimpleEncoder, depuis le repos 11
+static const uint8_t ENCODER_SEQUENCE[4] = { 3, 2, 0, 1 };
+// Une transition toutes les 3 ms: un cran en 12 ms, rotation franche
+static const uint32_t ENCODER_TRANSITION_MS = 3;
+static int encoderPhase = 0;
+static int encoderPendingSteps = 0;
+static uint32_t encoderNextTime = 0;
+
+static int buttonPin(const char* name) {
+  if (!strcmp(name, "hold"))  return PIN_BTN_HOLD;
+  if (!strcmp(name, "mode"))  return PIN_BTN_MODE;
+  if (!strcmp(name, "plus"))  return PIN_BTN_OCT_PLUS;
+  if (!strcmp(name, "minus")) return PIN_BTN_OCT_MINUS;
+  return -1;
+}
+
+bool hostScenarioLoad(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "scenario: impossible d'ouvrir %s\n", path);
+    return false;
+  }
+  char line[256];
+  int lineNumber = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), f)) {
+    lineNumber++;
+    char* comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char* tokens[20];
+    int count = 0;
+    for (char* t = strtok(line, " \t\r\n"); t && count < 20; t = strtok(nullptr, " \t\r\n")) tokens[count++] = t;
+    if (count == 0) continue;
+
+    ScenarioEvent e;
+    e.time_ms = strtoul(tokens[0], nullptr, 10);
+    e.arg0 = 0;
+    e.arg1 = 0;
+    bool valid = (count >= 2);
+    if (valid && !strcmp(tokens[1], "key") && count == 4) {
+      e.op = ScenarioOp::KEY;
+      e.arg0 = atoi(tokens[2]);
+      e.arg1 = atoi(tokens[3]);
+      valid = (e.arg0 >= 0 && e.arg0 < NUM_KEYS);
+    } else if (valid && !strcmp(tokens[1], "button") && count == 4) {
+      e.op = ScenarioOp::BUTTON;
+      e.arg0 = buttonPin(tokens[2]);
+      e.arg1 = !strcmp(tokens[3], "down");
+      valid = (e.arg0 >= 0) && (e.arg1 || !strcmp(tokens[3], "up"));
+    } else if (valid && !strcmp(tokens[1], "encoder") && count == 3) {
+      e.op = ScenarioOp::ENCODER;
+      e.arg0 = atoi(tokens[2]) * ENCODER_STEPS_PER_DETENT;
+    } else if (valid && !strcmp(tokens[1], "pot") && count == 3) {
+      e.op = ScenarioOp::POT;
+      e.arg0 = constrain(atoi(tokens[2]), 0, 1023);
+    } else if (valid && !strcmp(tokens[1], "midi") && count >= 3) {
+      e.op = ScenarioOp::MIDI;
+      for (int i = 2; i < count; i++) e.bytes.push_back((uint8_t)strtoul(tokens[i], nullptr, 16));
+    } else {
+      valid = false;
+    }
+
+    if (!valid) {
+      fprintf(stderr, "scenario: %s:%d: commande invalide\n", path, lineNumber);
+      ok = false;
+      continue;
+    }
+    if (!events.empty() && e.time_ms < events.back().time_ms) {
+      fprintf(stderr, "scenario: %s:%d: horodatage non croissant\n", path, lineNumber);
+      ok = false;
+      continue;
+    }
+    events.push_back(e);
+  }
+  fclose(f);
+  nextEvent = 0;
+  return ok;
+}
+
+uint32_t hostScenarioEndMillis() {
+  return events.empty() ? 0 : events.back().time_ms;
+}
+
+void hostScenarioApply(uint32_t now_ms) {
+  while (nextEvent < events.size() && events[nextEvent].time_ms <= now_ms) {
+    const ScenarioEvent& e = events[nextEvent++];
+    switch (e.op) {
+      case ScenarioOp::KEY:     hostBoardSetKeyDelta(e.arg0, e.arg1); break;
+      case ScenarioOp::BUTTON:  hostSetPinInput(e.arg0, e.arg1 ? LOW : HIGH); break;
+      case ScenarioOp::ENCODER: encoderPendingSteps += e.arg0; break;
+      case ScenarioOp::POT:     hostSetAnalogInput(PIN_POT_SENS, e.arg0); break;
+      case ScenarioOp::MIDI:    hostSerialInject(e.bytes.data(), e.bytes.size()); break;
+    }
+  }
+
+  if (encoderPendingSteps != 0 && now_ms >= encoderNextTime) {
+    int direction = (encoderPendingSteps > 0) ? 1 : -1;
+    encoderPhase = (encoderPhase + direction) & 3;
+    encoderPendingSteps -= direction;
+    encoderNextTime = now_ms + ENCODER_TRANSITION_MS;
+    uint8_t state = ENCODER_SEQUENCE[encoderPhase];
+    hostSetPinInput(PIN_ENCODER_A, (state >> 1) & 1);
+    hostSetPinInput(PIN_ENCODER_B, state & 1);
+  }
+}
+
+// =================================================================
+// Trace
+// =================================================================
+static FILE* traceOut = nullptr;
+static uint16_t tracedCode[2];
+static uint32_t tracedKeys = 0;
+
+static void tracePinWrite(uint8_t pin, int level) {
+  if (pin == PIN_GATE) fprintf(traceOut, "%llu GATE %d\n", (unsigned long long)hostNowMicros(), level);
+  else if (pin == PIN_TRIGGER) fprintf(traceOut, "%llu TRIG %d\n", (unsigned long long)hostNowMicros(), level);
+}
+
+void hostTraceBegin(FILE* out) {
+  traceOut = out;
+  tracedCode[0] = hostBoardDac().getCode(0);
+  tracedCode[1] = hostBoardDac().getCode(1);
+  hostSetPinWriteHook(tracePinWrite);
+}
+
+void hostTraceSample(uint32_t pressedMask) {
+  if (!traceOut) return;
+  unsigned long long now = hostNowMicros();
+  for (uint8_t c = 0; c < 2; c++) {
+    uint16_t code = hostBoardDac().getCode(c);
+    if (code != tracedCode[c]) {
+      fprintf(traceOut, "%llu CV%u %u\n", now, c, code);
+      tracedCode[c] = code;
+    }
+  }
+  if (pressedMask != tracedKeys) {
+    fprintf(traceOut, "%llu KEYS %06lX\n", now, (unsigned long)pressedMask);
+    tracedKeys = pressedMask;
+  }
+  uint8_t tx[64];
+  size_t n;
+  while ((n = hostSerialTakeTx(tx, sizeof(tx))) > 0) {
+    fprintf(traceOut, "%llu TX", now);
+    for (size_t i = 0; i < n; i++) fprintf(traceOut, " %02X", tx[i]);
+    fprintf(traceOut, "\n");
+  }
+}
+
+// =================================================================
+// Rejeu complet et comparaison à une trace de référence
+// =================================================================
+unsigned long hostScenarioRun(uint32_t tail_ms, uint32_t loopCost_us, FILE* trace) {
+  uint64_t start_us = hostNowMicros();
+  uint64_t end_us = start_us + (uint64_t)(hostScenarioEndMillis() + tail_ms) * 1000;
+  if (trace) hostTraceBegin(trace);
+
+  unsigned long n = 0;
+  while (hostNowMicros() < end_us) {
+    hostScenarioApply((uint32_t)((hostNowMicros() - start_us) / 1000));
+    loop();
+    hostAdvanceMicros(loopCost_us);
+    if (trace) hostTraceSample(keyboard.getPressedMask());
+    n++;
+  }
+  return n;
+}
+
+static void stripNewline(char* line) {
+  line[strcspn(line, "\r\n")] = '\0';
+}
+
+bool hostScenarioCheck(const char* scenarioPath, const char* expectedPath, char* message, size_t messageSize) {
+  FILE* expected = fopen(expectedPath, "r");
+  if (!expected) {
+    snprintf(message, messageSize, "trace attendue introuvable: %s", expectedPath);
+    return false;
+  }
+  if (!hostScenarioLoad(scenarioPath)) {
+    snprintf(message, messageSize, "scenario invalide: %s", scenarioPath);
+    fclose(expected);
+    return false;
+  }
+
+  FILE* actual = tmpfile();
+  if (!actual) {
+    snprintf(message, messageSize, "fichier temporaire impossible");
+    fclose(expected);
+    return false;
+  }
+  hostSerialSetTextOutput(false);
+  hostBoardInit();
+  setup();
+  hostScenarioRun(HOST_SCENARIO_TAIL_MS, HOST_SCENARIO_LOOP_US, actual);
+  rewind(actual);
+
+  char expectedLine[256], actualLine[256];
+  unsigned lineNumber = 0;
+  bool match = true;
+  while (match) {
+    bool moreExpected = fgets(expectedLine, sizeof(expectedLine), expected) != nullptr;
+    bool moreActual = fgets(actualLine, sizeof(actualLine), actual) != nullptr;
+    lineNumber++;
+    if (!moreExpected && !moreActual) break;
+    if (moreExpected) stripNewline(expectedLine);
+    if (moreActual) stripNewline(actualLine);
+    if (moreExpected != moreActual || strcmp(expectedLine, actualLine) != 0) {
+      snprintf(message, messageSize, "ligne %u: attendu \"%s\", obtenu \"%s\"", lineNumber,
+               moreExpected ? expectedLine : "<fin>", moreActual ? actualLine : "<fin>");
+      match = false;
+    }
+  }
+  fclose(actual);
+  fclose(expected);
+  return match;
+}
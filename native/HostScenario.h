@@ -0,0 +1,53 @@
+#ifndef HOST_SCENARIO_H
+#define HOST_SCENARIO_H
+
+// =================================================================
+// Rejeu de scénarios et trace des sorties (exécutable hôte)
+// =================================================================
+// Un scénario est un fichier texte, une commande par ligne, horodatée en ms
+// depuis la fin de setup(). '#' commence un commentaire.
+//
+//   100  key 5 250          touche 5: chute de 250 counts sur l'électrode (0 = relâchée)
+//   400  button hold down   hold | mode | plus | minus, down | up
+//   600  encoder -3         crans de l'encodeur (4 transitions quadrature par cran)
+//   700  pot 512            entrée analogique du potentiomètre SENS (0-1023)
+//   800  midi 90 3C 64      octets injectés sur le port série (hexadécimal)
+//
+// La trace liste, une ligne par changement et en µs virtuelles, les sorties observables:
+// GATE/TRIG (broches), CV0/CV1 (codes DAC), KEYS (masque des touches enfoncées), TX (octets série).
+// Deux traces d'un même scénario sont identiques tant que le comportement ne change pas:
+// c'est le moyen de valider un refactoring du chemin critique sans la carte.
+//
+// Les scénarios de référence et leur trace attendue sont versionnés dans test/test_scenario_*/
+// (scenario.txt, expected.trace) et rejoués par `pio test -e native`. Après un changement de
+// comportement voulu, la trace se regénère avec l'exécutable natif:
+//   .pio/build/native/program --script test/test_scenario_X/scenario.txt
+//                             --trace test/test_scenario_X/expected.trace   (une seule ligne)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Paramètres communs à l'exécutable et aux tests: temps CPU simulé par loop(), et durée
+// rejouée après la dernière commande du scénario
+const uint32_t HOST_SCENARIO_LOOP_US = 50;
+const uint32_t HOST_SCENARIO_TAIL_MS = 500;
+
+bool hostScenarioLoad(const char* path);
+uint32_t hostScenarioEndMillis();        // Horodatage de la dernière commande
+void hostScenarioApply(uint32_t now_ms); // Applique les commandes échues et fait tourner l'encodeur
+
+void hostTraceBegin(FILE* out);
+void hostTraceSample(uint32_t pressedMask);  // À appeler après chaque loop()
+
+// Rejoue le scénario chargé sur le firmware démarré (setup() fait) jusqu'à sa dernière commande
+// + tail_ms: une loop() puis loopCost_us de temps simulé par itération. trace peut être nul.
+// Renvoie le nombre d'itérations.
+unsigned long hostScenarioRun(uint32_t tail_ms, uint32_t loopCost_us, FILE* trace);
+
+// Non-régression: démarre le firmware, rejoue scenarioPath avec les paramètres de l'exécutable
+// et compare la trace à expectedPath ligne à ligne. En cas d'écart, message décrit la première
+// ligne différente.
+bool hostScenarioCheck(const char* scenarioPath, const char* expectedPath, char* message, size_t messageSize);
+
+#endif // HOST_SCENARIO_H
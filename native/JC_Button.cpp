@@ -0,0 +1,27 @@
+#include "JC_Button.h"
+
+void Button::begin() {
+  pinMode(m_pin, m_puEnable ? INPUT_PULLUP : INPUT);
+  m_state = digitalRead(m_pin);
+  if (m_invert) m_state = !m_state;
+  m_time = millis();
+  m_lastState = m_state;
+  m_changed = false;
+  m_lastChange = m_time;
+}
+
+bool Button::read() {
+  uint32_t ms = millis();
+  bool pinVal = digitalRead(m_pin);
+  if (m_invert) pinVal = !pinVal;
+  if (ms - m_lastChange < m_dbTime) {
+    m_changed = false;
+  } else {
+    m_lastState = m_state;
+    m_state = pinVal;
+    m_changed = (m_state != m_lastState);
+    if (m_changed) m_lastChange = ms;
+  }
+  m_time = ms;
+  return m_state;
+}
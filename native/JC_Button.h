@@ -0,0 +1,35 @@
+#ifndef HOST_JC_BUTTON_H
+#define HOST_JC_BUTTON_H
+
+// Réimplémentation hôte de JC_Button (même anti-rebond, même sémantique d'événements).
+
+#include "Arduino.h"
+
+class Button {
+public:
+  Button(uint8_t pin, uint32_t dbTime = 25, uint8_t puEnable = true, uint8_t invert = true)
+    : m_pin(pin), m_dbTime(dbTime), m_puEnable(puEnable), m_invert(invert) {}
+
+  void begin();
+  bool read();
+  bool isPressed() const { return m_state; }
+  bool isReleased() const { return !m_state; }
+  bool wasPressed() const { return m_state && m_changed; }
+  bool wasReleased() const { return !m_state && m_changed; }
+  bool pressedFor(uint32_t ms) const { return m_state && m_time - m_lastChange >= ms; }
+  bool releasedFor(uint32_t ms) const { return !m_state && m_time - m_lastChange >= ms; }
+  uint32_t lastChange() const { return m_lastChange; }
+
+private:
+  uint8_t  m_pin;
+  uint32_t m_dbTime;
+  bool     m_puEnable;
+  bool     m_invert;
+  bool     m_state = false;
+  bool     m_lastState = false;
+  bool     m_changed = false;
+  uint32_t m_time = 0;
+  uint32_t m_lastChange = 0;
+};
+
+#endif // HOST_JC_BUTTON_H
@@ -0,0 +1,247 @@
+#ifndef HOST_MIDI_H
+#define HOST_MIDI_H
+
+// Réimplémentation hôte du sous-ensemble de la MIDI Library (FortySevenEffects) utilisé par
+// le firmware: transport série, parseur avec running status, callbacks et envois (running status
+// en émission si Settings::UseRunningStatus).
+
+#include "Arduino.h"
+
+#define MIDI_CHANNEL_OMNI 0
+#define MIDI_CHANNEL_OFF  17
+
+namespace midi {
+
+typedef uint8_t Channel;
+typedef uint8_t DataByte;
+
+enum MidiType : uint8_t {
+  InvalidType           = 0x00,
+  NoteOff               = 0x80,
+  NoteOn                = 0x90,
+  AfterTouchPoly        = 0xA0,
+  ControlChange         = 0xB0,
+  ProgramChange         = 0xC0,
+  AfterTouchChannel     = 0xD0,
+  PitchBend             = 0xE0,
+  SystemExclusive       = 0xF0,
+  TimeCodeQuarterFrame  = 0xF1,
+  SongPosition          = 0xF2,
+  SongSelect            = 0xF3,
+  TuneRequest           = 0xF6,
+  Clock                 = 0xF8,
+  Tick                  = 0xF9,
+  Start                 = 0xFA,
+  Continue              = 0xFB,
+  Stop                  = 0xFC,
+  ActiveSensing         = 0xFE,
+  SystemReset           = 0xFF,
+};
+
+// Réglages à la compilation, comme la bibliothèque: on dérive de DefaultSettings et on masque
+struct DefaultSettings {
+  static const bool UseRunningStatus = false;
+  static const bool Use1ByteParsing = true;  // read() consomme au plus un octet
+};
+
+template <class SerialPort>
+class SerialMIDI {
+public:
+  explicit SerialMIDI(SerialPort& port) : _port(port) {}
+  void begin() { _port.begin(31250); }
+  void write(uint8_t b) { _port.write(b); }
+  unsigned available() { return _port.available(); }
+  uint8_t read() { return (uint8_t)_port.read(); }
+
+private:
+  SerialPort& _port;
+};
+
+template <class Transport, class Settings = DefaultSettings>
+class MidiInterface {
+public:
+  explicit MidiInterface(Transport& transport) : _transport(transport) {}
+
+  void begin(Channel inChannel = 1) {
+    _inputChannel = inChannel;
+    _transport.begin();
+    _runningStatus = 0;
+    _pendingLength = 0;
+    _runningStatusTx = 0;
+  }
+
+  // --- Réception ---
+  bool read() { return read(_inputChannel); }
+
+  bool read(Channel inChannel) {
+    if (inChannel >= MIDI_CHANNEL_OFF) return false;
+    while (_transport.available()) {
+      if (parse(_transport.read())) {
+        if (!channelMatches(inChannel)) return false;
+        launchCallback();
+        return true;
+      }
+      if (Settings::Use1ByteParsing) return false;
+    }
+    return false;
+  }
+
+  MidiType getType() const { return _type; }
+  Channel  getChannel() const { return _channel; }
+  DataByte getData1() const { return _data1; }
+  DataByte getData2() const { return _data2; }
+
+  // --- Émission (running status seulement si Settings::UseRunningStatus) ---
+  void sendNoteOn(DataByte note, DataByte velocity, Channel channel) { send(NoteOn, note, velocity, channel); }
+  void sendNoteOff(DataByte note, DataByte velocity, Channel channel) { send(NoteOff, note, velocity, channel); }
+  void sendControlChange(DataByte number, DataByte value, Channel channel) { send(ControlChange, number, value, channel); }
+  void sendProgramChange(DataByte number, Channel channel) { send(ProgramChange, number, 0, channel); }
+  void sendAfterTouch(DataByte pressure, Channel channel) { send(AfterTouchChannel, pressure, 0, channel); }
+  void sendAfterTouch(DataByte note, DataByte pressure, Channel channel) { send(AfterTouchPoly, note, pressure, channel); }
+  void sendPolyPressure(DataByte note, DataByte pressure, Channel channel) { send(AfterTouchPoly, note, pressure, channel); }
+
+  void sendPitchBend(int value, Channel channel) {
+    unsigned bend = (unsigned)(value + 8192) & 0x3FFF;
+    send(PitchBend, bend & 0x7F, (bend >> 7) & 0x7F, channel);
+  }
+
+  // Temps réel: peut s'intercaler n'importe où, le running status est conservé
+  void sendRealTime(MidiType type) {
+    if (type >= Clock) _transport.write((uint8_t)type);
+  }
+
+  void send(MidiType type, DataByte data1, DataByte data2, Channel channel) {
+    if (channel == 0 || channel > 16 || type < NoteOff || type >= SystemExclusive) return;
+    uint8_t status = (uint8_t)type | ((channel - 1) & 0x0F);
+    if (!Settings::UseRunningStatus || status != _runningStatusTx) {
+      _transport.write(status);
+      _runningStatusTx = Settings::UseRunningStatus ? status : 0;
+    }
+    _transport.write(data1 & 0x7F);
+    if (type != ProgramChange && type != AfterTouchChannel) _transport.write(data2 & 0x7F);
+  }
+
+  void turnThruOn() {}
+  void turnThruOff() {}
+
+  // --- Callbacks ---
+  void setHandleNoteOff(void (*fptr)(Channel, DataByte, DataByte)) { _noteOff = fptr; }
+  void setHandleNoteOn(void (*fptr)(Channel, DataByte, DataByte)) { _noteOn = fptr; }
+  void setHandleAfterTouchPoly(void (*fptr)(Channel, DataByte, DataByte)) { _afterTouchPoly = fptr; }
+  void setHandleControlChange(void (*fptr)(Channel, DataByte, DataByte)) { _controlChange = fptr; }
+  void setHandleProgramChange(void (*fptr)(Channel, DataByte)) { _programChange = fptr; }
+  void setHandleAfterTouchChannel(void (*fptr)(Channel, DataByte)) { _afterTouchChannel = fptr; }
+  void setHandlePitchBend(void (*fptr)(Channel, int)) { _pitchBend = fptr; }
+  void setHandleClock(void (*fptr)()) { _clock = fptr; }
+  void setHandleStart(void (*fptr)()) { _start = fptr; }
+  void setHandleContinue(void (*fptr)()) { _continue = fptr; }
+  void setHandleStop(void (*fptr)()) { _stop = fptr; }
+
+private:
+  static uint8_t dataLength(uint8_t status) {
+    switch (status & 0xF0) {
+      case ProgramChange:
+      case AfterTouchChannel: return 1;
+      case 0xF0:
+        if (status == SongPosition) return 2;
+        if (status == TimeCodeQuarterFrame || status == SongSelect) return 1;
+        return 0;
+      default: return 2;
+    }
+  }
+
+  // Renvoie true quand un message complet est disponible
+  bool parse(uint8_t b) {
+    if (b >= Clock) {  // Temps réel: peut s'intercaler n'importe où
+      _type = (MidiType)b; _channel = 0; _data1 = _data2 = 0;
+      return true;
+    }
+    if (b & 0x80) {
+      _pendingLength = 0;
+      if (b >= SystemExclusive) {  // Message système commun: annule le running status
+        _runningStatus = 0;
+        if (b == SystemExclusive || b == 0xF7) return false;  // SysEx ignoré
+        if (dataLength(b) == 0) { _type = (MidiType)b; _channel = 0; _data1 = _data2 = 0; return true; }
+      }
+      _runningStatus = b;
+      return false;
+    }
+    if (_runningStatus == 0) return false;  // Octet de données orphelin
+    uint8_t length = dataLength(_runningStatus);
+    _pending[_pendingLength++] = b;
+    if (_pendingLength < length) return false;
+    _pendingLength = 0;
+
+    if (_runningStatus < SystemExclusive) {
+      _type = (MidiType)(_runningStatus & 0xF0);
+      _channel = (_runningStatus & 0x0F) + 1;
+    } else {
+      _type = (MidiType)_runningStatus;
+      _channel = 0;
+      _runningStatus = 0;
+    }
+    _data1 = _pending[0];
+    _data2 = (length > 1) ? _pending[1] : 0;
+    if (_type == NoteOn && _data2 == 0) _type = NoteOff;  // Vélocité nulle = Note Off
+    return true;
+  }
+
+  bool channelMatches(Channel inChannel) const {
+    if (_type >= SystemExclusive || _type == InvalidType) return true;
+    return inChannel == MIDI_CHANNEL_OMNI || inChannel == _channel;
+  }
+
+  void launchCallback() {
+    switch (_type) {
+      case NoteOff:           if (_noteOff) _noteOff(_channel, _data1, _data2); break;
+      case NoteOn:            if (_noteOn) _noteOn(_channel, _data1, _data2); break;
+      case AfterTouchPoly:    if (_afterTouchPoly) _afterTouchPoly(_channel, _data1, _data2); break;
+      case ControlChange:     if (_controlChange) _controlChange(_channel, _data1, _data2); break;
+      case ProgramChange:     if (_programChange) _programChange(_channel, _data1); break;
+      case AfterTouchChannel: if (_afterTouchChannel) _afterTouchChannel(_channel, _data1); break;
+      case PitchBend:
+        if (_pitchBend) _pitchBend(_channel, (int)((_data1 & 0x7F) | ((_data2 & 0x7F) << 7)) - 8192);
+        break;
+      case Clock:             if (_clock) _clock(); break;
+      case Start:             if (_start) _start(); break;
+      case Continue:          if (_continue) _continue(); break;
+      case Stop:              if (_stop) _stop(); break;
+      default: break;
+    }
+  }
+
+  Transport& _transport;
+  Channel  _inputChannel = 1;
+  uint8_t  _runningStatus = 0;
+  uint8_t  _runningStatusTx = 0;
+  uint8_t  _pending[2];
+  uint8_t  _pendingLength = 0;
+  MidiType _type = InvalidType;
+  Channel  _channel = 0;
+  DataByte _data1 = 0;
+  DataByte _data2 = 0;
+
+  void (*_noteOff)(Channel, DataByte, DataByte) = nullptr;
+  void (*_noteOn)(Channel, DataByte, DataByte) = nullptr;
+  void (*_afterTouchPoly)(Channel, DataByte, DataByte) = nullptr;
+  void (*_controlChange)(Channel, DataByte, DataByte) = nullptr;
+  void (*_programChange)(Channel, DataByte) = nullptr;
+  void (*_afterTouchChannel)(Channel, DataByte) = nullptr;
+  void (*_pitchBend)(Channel, int) = nullptr;
+  void (*_clock)() = nullptr;
+  void (*_start)() = nullptr;
+  void (*_continue)() = nullptr;
+  void (*_stop)() = nullptr;
+};
+
+} // namespace midi
+
+#define MIDI_CREATE_INSTANCE(Type, SerialPort, Name)                 \
+  midi::SerialMIDI<Type> serial##Name(SerialPort);                   \
+  midi::MidiInterface<midi::SerialMIDI<Type>> Name(serial##Name);
+
+#define MIDI_CREATE_CUSTOM_INSTANCE(Type, SerialPort, Name, Settings)  \
+  midi::SerialMIDI<Type> serial##Name(SerialPort);                     \
+  midi::MidiInterface<midi::SerialMIDI<Type>, Settings> Name(serial##Name);
+
+#endif // HOST_MIDI_H
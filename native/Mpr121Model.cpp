@@ -0,0 +1,134 @@
+#include "Mpr121Model.h"
+#include <string.h>
+
+Mpr121Model::Mpr121Model(uint8_t address, uint8_t irqPin, uint8_t irqSource)
+  : _address(address), _irqPin(irqPin), _irqSource(irqSource) {
+  _idleLevel = 700;
+  _statusReads = 0;
+  memset(_touchDelta, 0, sizeof(_touchDelta));
+  reset();
+}
+
+void Mpr121Model::reset() {
+  memset(_regs, 0, sizeof(_regs));
+  _regs[0x5C] = 0x10;  // AFE1 (valeurs de reset de la datasheet)
+  _regs[0x5D] = 0x24;  // AFE2
+  _pointer = 0;
+  _touchStatus = 0;
+  _autoconfigLevel = 0;
+  setIrq(false);
+}
+
+void Mpr121Model::setIdleLevel(uint16_t level) {
+  _idleLevel = level > 1023 ? 1023 : level;
+  updateTouchStatus();
+}
+
+void Mpr121Model::setTouchDelta(uint8_t electrode, uint16_t delta) {
+  if (electrode >= NUM_ELECTRODES) return;
+  _touchDelta[electrode] = delta;
+  updateTouchStatus();
+}
+
+uint16_t Mpr121Model::getTouchDelta(uint8_t electrode) const {
+  return (electrode < NUM_ELECTRODES) ? _touchDelta[electrode] : 0;
+}
+
+void Mpr121Model::onWrite(const uint8_t* data, size_t len) {
+  _pointer = data[0];
+  for (size_t i = 1; i < len; i++) {
+    writeRegister(_pointer, data[i]);
+    _pointer = (_pointer + 1) & 0x7F;
+  }
+}
+
+size_t Mpr121Model::onRead(uint8_t* out, size_t len) {
+  bool statusRead = false;
+  for (size_t i = 0; i < len; i++) {
+    if (_pointer <= 0x01) statusRead = true;
+    out[i] = readRegister(_pointer);
+    _pointer = (_pointer + 1) & 0x7F;
+  }
+  if (statusRead) {
+    _statusReads++;
+    setIrq(false);
+  }
+  return len;
+}
+
+void Mpr121Model::writeRegister(uint8_t reg, uint8_t value) {
+  if (reg == REG_SOFT_RESET) {
+    if (value == 0x63) reset();
+    return;
+  }
+  if (reg > 0x7F) return;
+
+  if (reg == REG_ECR) {
+    bool wasRunning = isRunning();
+    _regs[REG_ECR] = value;
+    if (!wasRunning && isRunning()) {
+      // Autoconfiguration: le courant/temps de charge sont ajustés pour amener le repos sur TL
+      _autoconfigLevel = (_regs[REG_AUTOCONFIG0] & 0x01) ? (uint16_t)(_regs[REG_TL] << 2) : 0;
+    }
+    updateTouchStatus();
+    return;
+  }
+
+  if (isRunning()) return;  // Registres de configuration verrouillés en mode run
+  _regs[reg] = value;
+}
+
+uint8_t Mpr121Model::readRegister(uint8_t reg) {
+  if (reg <= 0x01) {
+    return (reg == 0x00) ? (_touchStatus & 0xFF) : ((_touchStatus >> 8) & 0x1F);
+  }
+  if (reg <= 0x03) return 0;
+  if (reg < REG_BASELINE) {
+    uint8_t electrode = (reg - REG_FILTERED) / 2;
+    uint16_t value = filteredValue(electrode);
+    return ((reg - REG_FILTERED) & 1) ? (value >> 8) & 0x03 : value & 0xFF;
+  }
+  if (reg <= 0x2A) {
+    uint8_t electrode = reg - REG_BASELINE;
+    // Baseline figée au repos: la touche n'influence pas la baseline pendant l'appui
+    return (isRunning() && electrode < NUM_ELECTRODES) ? (idleValue() >> 2) : 0;
+  }
+  return _regs[reg];
+}
+
+uint16_t Mpr121Model::idleValue() const {
+  return _autoconfigLevel ? _autoconfigLevel : _idleLevel;
+}
+
+uint16_t Mpr121Model::filteredValue(uint8_t electrode) const {
+  uint8_t enabled = _regs[REG_ECR] & 0x0F;
+  if (electrode >= NUM_ELECTRODES || electrode >= enabled) return 0;
+  uint16_t idle = idleValue();
+  uint16_t delta = _touchDelta[electrode];
+  return (delta >= idle) ? 0 : idle - delta;
+}
+
+void Mpr121Model::updateTouchStatus() {
+  uint16_t status = 0;
+  if (isRunning()) {
+    for (uint8_t e = 0; e < NUM_ELECTRODES; e++) {
+      uint16_t baseline = (idleValue() >> 2) << 2;
+      uint16_t filtered = filteredValue(e);
+      uint16_t delta = (baseline > filtered) ? baseline - filtered : 0;
+      uint8_t touchThreshold = _regs[REG_THRESHOLDS + 2 * e];
+      uint8_t releaseThreshold = _regs[REG_THRESHOLDS + 2 * e + 1];
+      bool touched = (_touchStatus >> e) & 1;
+      if (!touched && delta > touchThreshold) touched = true;
+      else if (touched && delta < releaseThreshold) touched = false;
+      if (touched) status |= (1 << e);
+    }
+  }
+  if (status != _touchStatus) {
+    _touchStatus = status;
+    setIrq(true);
+  }
+}
+
+void Mpr121Model::setIrq(bool asserted) {
+  hostSetOpenDrain(_irqPin, _irqSource, asserted);
+}
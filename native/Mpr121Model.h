@@ -0,0 +1,71 @@
+#ifndef MPR121_MODEL_H
+#define MPR121_MODEL_H
+
+// =================================================================
+// Modèle registre du MPR121 pour la HAL hôte
+// =================================================================
+// Fidèle à la carte mémoire utilisée par CapacitiveKeyboard:
+//  - 0x00-0x01 statut touch (bits 0-11), 0x02-0x03 statut hors-plage (toujours 0)
+//  - 0x04-0x1D données filtrées 10 bits (13 électrodes, LSB puis MSB)
+//  - 0x1E-0x2A baselines (8 bits de poids fort)
+//  - 0x41-0x5A seuils touch/release, 0x5B-0x5D filtres, 0x5E ECR, 0x7B-0x7F autoconfig
+//  - 0x80 soft reset (0x63)
+// Le pointeur de registre s'auto-incrémente. En mode run (ECR != 0), seules les écritures
+// dans l'ECR et le soft reset sont prises en compte, comme sur le composant.
+// La sortie IRQ (open-drain) passe basse à chaque changement du statut touch et
+// se relâche à la lecture des registres de statut.
+
+#include "HostHal.h"
+
+class Mpr121Model : public HostI2cDevice {
+public:
+  static const uint8_t NUM_ELECTRODES = 12;
+
+  Mpr121Model(uint8_t address, uint8_t irqPin, uint8_t irqSource);
+
+  uint8_t address() const override { return _address; }
+  void onWrite(const uint8_t* data, size_t len) override;
+  size_t onRead(uint8_t* out, size_t len) override;
+
+  // Stimulus: chute de la donnée filtrée (en counts 10 bits) due au doigt sur l'électrode
+  void setTouchDelta(uint8_t electrode, uint16_t delta);
+  uint16_t getTouchDelta(uint8_t electrode) const;
+
+  // Niveau de repos sans autoconfiguration (counts 10 bits)
+  void setIdleLevel(uint16_t level);
+
+  bool isRunning() const { return (_regs[REG_ECR] & 0x0F) != 0; }
+  uint16_t getTouchStatus() const { return _touchStatus; }
+  uint32_t getStatusReads() const { return _statusReads; }
+
+private:
+  static const uint8_t REG_TOUCH_STATUS = 0x00;
+  static const uint8_t REG_FILTERED     = 0x04;
+  static const uint8_t REG_BASELINE     = 0x1E;
+  static const uint8_t REG_THRESHOLDS   = 0x41;
+  static const uint8_t REG_ECR          = 0x5E;
+  static const uint8_t REG_AUTOCONFIG0  = 0x7B;
+  static const uint8_t REG_TL           = 0x7F;
+  static const uint8_t REG_SOFT_RESET   = 0x80;
+
+  void reset();
+  void writeRegister(uint8_t reg, uint8_t value);
+  uint8_t readRegister(uint8_t reg);
+  uint16_t filteredValue(uint8_t electrode) const;
+  uint16_t idleValue() const;
+  void updateTouchStatus();
+  void setIrq(bool asserted);
+
+  uint8_t  _address;
+  uint8_t  _irqPin;
+  uint8_t  _irqSource;
+  uint8_t  _regs[0x81];
+  uint8_t  _pointer;
+  uint16_t _touchDelta[NUM_ELECTRODES];
+  uint16_t _touchStatus;
+  uint16_t _idleLevel;
+  uint16_t _autoconfigLevel;  // Niveau atteint par l'autoconfiguration au passage en run
+  uint32_t _statusReads;
+};
+
+#endif // MPR121_MODEL_H
@@ -0,0 +1,64 @@
+#include "Wire.h"
+
+TwoWire Wire;
+TwoWire Wire1;
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _txAddress = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLength >= BUFFER_LENGTH) return 0;
+  _txBuffer[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  HostI2cDevice* device = hostI2cFind(_txAddress);
+  if (!device) {
+    hostI2cAccountBytes(1);  // Adresse seule, puis NACK
+    _txLength = 0;
+    return 2;
+  }
+  hostI2cAccountBytes(1 + _txLength);
+  if (_txLength > 0) device->onWrite(_txBuffer, _txLength);
+  _txLength = 0;
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool sendStop) {
+  (void)sendStop;
+  _rxLength = 0;
+  _rxIndex = 0;
+  HostI2cDevice* device = hostI2cFind(address);
+  if (!device) {
+    hostI2cAccountBytes(1);
+    return 0;
+  }
+  if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+  _rxLength = device->onRead(_rxBuffer, quantity);
+  hostI2cAccountBytes(1 + _rxLength);
+  return _rxLength;
+}
+
+int TwoWire::available() {
+  return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+  if (_rxIndex >= _rxLength) return -1;
+  return _rxBuffer[_rxIndex++];
+}
+
+int TwoWire::peek() {
+  if (_rxIndex >= _rxLength) return -1;
+  return _rxBuffer[_rxIndex];
+}
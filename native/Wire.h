@@ -0,0 +1,40 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// TwoWire hôte: les transactions sont routées vers les modèles branchés sur le bus virtuel.
+// Le temps bus (adresse + données, 9 bits/octet) est imputé à l'horloge virtuelle.
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  static const size_t BUFFER_LENGTH = 64;
+
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t hz) { hostI2cSetClock(hz); }
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t len);
+  // 0 = succès, 2 = NACK sur l'adresse (comme le core Arduino)
+  uint8_t endTransmission(bool sendStop = true);
+
+  size_t requestFrom(uint8_t address, size_t quantity, bool sendStop = true);
+  int available();
+  int read();
+  int peek();
+
+private:
+  uint8_t _txAddress = 0;
+  uint8_t _txBuffer[BUFFER_LENGTH];
+  size_t  _txLength = 0;
+  uint8_t _rxBuffer[BUFFER_LENGTH];
+  size_t  _rxLength = 0;
+  size_t  _rxIndex = 0;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,135 @@
+// =================================================================
+// Exécutable hôte: setup() puis loop() sur la carte virtuelle
+// =================================================================
+// Options:
+//   --loops N     nombre d'itérations de loop() (défaut 10000)
+//   --eeprom F    fichier image de l'EEPROM (défaut: EEPROM vierge en mémoire)
+//   --loop-us N   temps CPU simulé par itération, en plus du temps bus I2C (défaut 50)
+//   --quiet       n'affiche pas les traces Serial du firmware
+//   --script F    rejoue le scénario F (voir HostScenario.h); la durée par défaut
+//                 devient la fin du scénario + 500 ms au lieu d'un nombre d'itérations
+//   --trace F     écrit la trace des sorties dans F ("-" = stdout, implique --quiet)
+//   --bench-latency N  mesure la latence touche -> sortie sur N appuis par moteur (HostBench.h)
+//   --bench-arp-drift N  mesure la dérive de l'horloge d'arpège sur N pas par tempo (HostBench.h)
+//   --bench-midi-clock N  mesure le suivi d'une horloge MIDI externe sur N temps (HostBench.h)
+//   --bench-pressure N  coût par touche de la chaîne de pression, fixe et flottante (HostBench.h)
+//   --profile     affiche les histogrammes du LoopProfiler (temps CPU du PC) et les compteurs
+//                 de l'ordonnanceur (temps virtuel) en fin d'exécution
+
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "HostScenario.h"
+#include "HostBench.h"
+#include "CapacitiveKeyboard.h"
+#include "LoopProfiler.h"
+#include "ControlScheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+void setup();
+void loop();
+extern CapacitiveKeyboard keyboard;
+extern LoopProfiler loopProfiler;
+extern ControlScheduler scheduler;
+
+// Les tests unitaires (test/, env:native) fournissent leur propre main()
+#ifndef PIO_UNIT_TESTING
+
+int main(int argc, char** argv) {
+  unsigned long loops = 10000;
+  unsigned long loopCost_us = HOST_SCENARIO_LOOP_US;
+  const char* eepromFile = nullptr;
+  bool quiet = false;
+  bool loopsGiven = false;
+  bool profile = false;
+  unsigned long benchLatencyNotes = 0;
+  unsigned long benchArpSteps = 0;
+  unsigned long benchClockBeats = 0;
+  unsigned long benchPressureRounds = 0;
+  const char* scriptFile = nullptr;
+  const char* traceFile = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--loops") && i + 1 < argc) loops = strtoul(argv[++i], nullptr, 10), loopsGiven = true;
+    else if (!strcmp(argv[i], "--eeprom") && i + 1 < argc) eepromFile = argv[++i];
+    else if (!strcmp(argv[i], "--loop-us") && i + 1 < argc) loopCost_us = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--quiet")) quiet = true;
+    else if (!strcmp(argv[i], "--script") && i + 1 < argc) scriptFile = argv[++i];
+    else if (!strcmp(argv[i], "--trace") && i + 1 < argc) traceFile = argv[++i];
+    else if (!strcmp(argv[i], "--profile")) profile = true;
+    else if (!strcmp(argv[i], "--bench-latency") && i + 1 < argc) benchLatencyNotes = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--bench-arp-drift") && i + 1 < argc) benchArpSteps = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--bench-midi-clock") && i + 1 < argc) benchClockBeats = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--bench-pressure") && i + 1 < argc) benchPressureRounds = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr, "usage: %s [--loops N] [--eeprom FILE] [--loop-us N] [--quiet] [--script FILE] [--trace FILE] [--profile] [--bench-latency N] [--bench-arp-drift N] [--bench-midi-clock N] [--bench-pressure N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  FILE* trace = nullptr;
+  if (traceFile) {
+    trace = strcmp(traceFile, "-") ? fopen(traceFile, "w") : stdout;
+    if (!trace) {
+      fprintf(stderr, "host: impossible d'ecrire %s\n", traceFile);
+      return 1;
+    }
+    if (trace == stdout) quiet = true;
+  }
+  if (scriptFile && !hostScenarioLoad(scriptFile)) return 1;
+
+  if (eepromFile) hostEepromSetFile(eepromFile);
+  hostSerialSetTextOutput(!quiet);
+  hostBoardInit();
+
+  setup();
+  if (benchLatencyNotes > 0) {
+    hostSerialSetTextOutput(false);
+    hostBenchLatency(benchLatencyNotes, loopCost_us);
+    return 0;
+  }
+  if (benchArpSteps > 0) {
+    hostSerialSetTextOutput(false);
+    hostBenchArpDrift(benchArpSteps, loopCost_us);
+    return 0;
+  }
+  if (benchClockBeats > 0) {
+    hostSerialSetTextOutput(false);
+    hostBenchMidiClock(benchClockBeats, loopCost_us);
+    return 0;
+  }
+  if (benchPressureRounds > 0) {
+    hostSerialSetTextOutput(false);
+    hostBenchPressureChain(benchPressureRounds);
+    return 0;
+  }
+
+  uint64_t start_us = hostNowMicros();
+  uint64_t startBytes = hostI2cTotalBytes();
+  if (scriptFile && !loopsGiven) {
+    loops = hostScenarioRun(HOST_SCENARIO_TAIL_MS, loopCost_us, trace);
+  } else {
+    if (trace) hostTraceBegin(trace);
+    for (unsigned long n = 0; n < loops; n++) {
+      if (scriptFile) hostScenarioApply((uint32_t)((hostNowMicros() - start_us) / 1000));
+      loop();
+      hostAdvanceMicros(loopCost_us);
+      if (trace) hostTraceSample(keyboard.getPressedMask());
+    }
+  }
+  uint64_t elapsed_us = hostNowMicros() - start_us;
+  if (trace && trace != stdout) fclose(trace);
+  if (profile) {
+    hostSerialSetTextOutput(true);
+    loopProfiler.dump(Serial);
+    scheduler.dump(Serial);
+  }
+
+  fprintf(stderr, "host: %lu loops, %.3f s virtuels, %.1f us/loop, %llu octets I2C, DAC %.3f V / %.3f V\n",
+          loops, elapsed_us / 1e6, loops ? (double)elapsed_us / loops : 0.0,
+          (unsigned long long)(hostI2cTotalBytes() - startBytes),
+          hostBoardDac().getVoltage(0), hostBoardDac().getVoltage(1));
+  return 0;
+}
+
+#endif // PIO_UNIT_TESTING
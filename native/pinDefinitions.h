@@ -0,0 +1,29 @@
+#ifndef HOST_PIN_DEFINITIONS_H
+#define HOST_PIN_DEFINITIONS_H
+
+// Sous-ensemble de pinDefinitions.h du core Renesas: configuration d'une broche pour une fonction.
+// Comme sur cible, getPinCfgs(pin, PIN_CFG_REQ_INTERRUPT)[0] == 0 signifie "pas de canal IRQ"
+// (voir hostSetPinInterruptCapable).
+
+#include <stdint.h>
+#include <array>
+
+typedef enum {
+  PIN_CFG_REQ_UART_TX,
+  PIN_CFG_REQ_UART_RX,
+  PIN_CFG_REQ_SCL,
+  PIN_CFG_REQ_SDA,
+  PIN_CFG_REQ_MISO,
+  PIN_CFG_REQ_MOSI,
+  PIN_CFG_REQ_SCK,
+  PIN_CFG_REQ_PWM,
+  PIN_CFG_REQ_INTERRUPT,
+  PIN_CFG_REQ_ADC,
+  PIN_CFG_REQ_CAN_RX,
+  PIN_CFG_REQ_CAN_TX,
+  PIN_CFG_REQ_DAC
+} PinCfgReq_t;
+
+std::array<uint16_t, 3> getPinCfgs(const uint8_t pin, PinCfgReq_t req);
+
+#endif // HOST_PIN_DEFINITIONS_H
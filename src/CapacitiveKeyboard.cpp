@@ -1,5 +1,6 @@
 #include "CapacitiveKeyboard.h"
 #include "HardwareConfig.h"
+#include "CycleCounter.h"
 #include <Arduino.h>
 #include <Wire.h>
 #include <EEPROM.h>
@@ -11,12 +12,30 @@
 #define MPR121_USL          0x7D
 #define MPR121_LSL          0x7E
 #define MPR121_TL           0x7F
+#define MPR121_TOUCH_STATUS 0x00
+#define MPR121_FILTERED     0x04
+
+// Burst complet: 12 x filtered (2 octets) + 2 octets ignorés + 12 x baseline (1 octet)
+#define MPR121_BURST_BYTES  38
+// Octets de protocole d'une lecture registre: adresse+registre en écriture, puis adresse en lecture
+#define I2C_READ_OVERHEAD   3
+
+static const uint8_t SENSOR_ADDRS[] = { ADDR_MPR121_A, ADDR_MPR121_B };
+
+volatile bool CapacitiveKeyboard::sensorIrqPending[CapacitiveKeyboard::NUM_SENSORS] = { true, true };
+
+void CapacitiveKeyboard::onSensorIrq() {
+  // Ligne IRQ partagée: on ne sait pas quel capteur l'a tirée, les deux statuts seront relus
+  sensorIrqPending[0] = true;
+  sensorIrqPending[1] = true;
+}
 
 void CapacitiveKeyboard::writeRegister(uint8_t addr, uint8_t reg, uint8_t value) {
   Wire1.beginTransmission(addr);
   Wire1.write(reg);
   Wire1.write(value);
   Wire1.endTransmission();
+  busBytesInWindow += 3;
 }
 
 uint8_t CapacitiveKeyboard::readRegister(uint8_t addr, uint8_t reg) {
@@ -24,28 +43,56 @@ uint8_t CapacitiveKeyboard::readRegister(uint8_t addr, uint8_t reg) {
   Wire1.write(reg);
   Wire1.endTransmission(false);
   Wire1.requestFrom(addr, (uint8_t)1);
+  busBytesInWindow += I2C_READ_OVERHEAD + 1;
   return Wire1.read();
 }
 
 CapacitiveKeyboard::CapacitiveKeyboard() {
   isInitialized = false;
   responseShape = 0.5f;
+  curveExpIntensity = AFTERTOUCH_CURVE_EXP_INTENSITY;
+  curveSigIntensity = AFTERTOUCH_CURVE_SIG_INTENSITY;
+  customCurveActive = false;
+  rebuildResponseCurve();
   currentTargetBaseline = 550;
   aftertouchDeadzoneOffset = 0; // Initialisation de la nouvelle variable
+  pressedMask = 0;
+  onsetMask = 0;
+  releaseMask = 0;
+  pressureChangedMask = 0;
+  scanTime_ms = 0;
+  scanMode = KEYBOARD_IRQ_SCAN_ENABLED ? ScanMode::IRQ_STATUS : ScanMode::POLL_ALL;
+  busBytesInWindow = 0;
+  busBytesPerSecond = 0;
+  aftertouchDeadband = AFTERTOUCH_DISPATCH_DEADBAND;
+  aftertouchMaxInterval_ms = AFTERTOUCH_DISPATCH_MAX_INTERVAL_MS;
+  aftertouchCandidatesInWindow = 0;
+  aftertouchDispatchesInWindow = 0;
+  aftertouchCandidatesPerSecond = 0;
+  aftertouchDispatchesPerSecond = 0;
+  statsWindowStart = 0;
+
+  nextSensor = 0;
+  frameSequence = 0;
+  keyProcessingTicks = 0;
+  frameTimestamp_us = 0;
+
+  for (int s = 0; s < NUM_SENSORS; s++) {
+    touchStatus[s] = 0;
+    lastBurstTime[s] = 0;
+    burstTimestamp_us[s] = 0;
+  }
 
   for (int i = 0; i < NUM_KEYS; i++) {
     filteredData[i] = 0;
     baselineData[i] = 0;
-    smoothedPressure[i] = 0.0f;
-    slewedPressure[i] = 0.0f;
     keyIsPressed[i] = false;
-    lastKeyIsPressed[i] = false;
+    lastPublishedPressure[i] = 0;
+    lastPublishedTime[i] = 0;
     calibrationMaxDelta[i] = 400;
     pressDeltaStart[i] = 0;
-    historyIndex[i] = 0;
-    for (int j = 0; j < AFTERTOUCH_SMOOTHING_WINDOW_SIZE; j++) {
-      pressureHistory[i][j] = 0.0f;
-    }
+    onsetTimestamp_us[i] = 0;
+    pressureChain[i].reset();
   }
 }
 
@@ -53,6 +100,12 @@ bool CapacitiveKeyboard::begin() {
   #if DEBUG_LEVEL >= 0
   Serial.println("INFO: Demarrage initialisation clavier capacitif...");
   #endif
+
+#if KEYBOARD_IRQ_SCAN_ENABLED
+  // Les deux sorties IRQ sont open-drain: pull-up interne, front descendant = changement de statut
+  pinMode(PIN_MPR121_IRQ, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(PIN_MPR121_IRQ), onSensorIrq, FALLING);
+#endif
   
   loadCalibrationData();
   #if DEBUG_LEVEL >= 0
@@ -82,95 +135,143 @@ bool CapacitiveKeyboard::begin() {
 void CapacitiveKeyboard::setResponseShape(float shape) {
     if (shape < 0.0f) shape = 0.0f;
     if (shape > 1.0f) shape = 1.0f;
+    if (shape == responseShape && !customCurveActive) return;
     responseShape = shape;
+    customCurveActive = false;
+    rebuildResponseCurve();
+}
+
+void CapacitiveKeyboard::setCurveIntensities(float expIntensity, uint8_t sigIntensity) {
+    if (expIntensity < 1.0f) expIntensity = 1.0f;
+    if (sigIntensity < 1) sigIntensity = 1;
+    if (expIntensity == curveExpIntensity && sigIntensity == curveSigIntensity && !customCurveActive) return;
+    curveExpIntensity = expIntensity;
+    curveSigIntensity = sigIntensity;
+    customCurveActive = false;
+    rebuildResponseCurve();
+}
+
+// Table de la courbe paramétrique (mélange lin/exp ou lin/sigmoïde), reconstruite à chaque
+// changement de forme: powf n'est jamais appelé dans le scan.
+void CapacitiveKeyboard::rebuildResponseCurve() {
+  buildResponseCurve(responseCurve, responseShape, curveExpIntensity, curveSigIntensity);
+}
+
+bool CapacitiveKeyboard::loadResponseCurve(const uint16_t* points, uint16_t count) {
+  // Points Q15 (32768 = 1.0) régulièrement espacés sur x = 0..1, rééchantillonnés dans la table
+  if (points == nullptr || count < 2) return false;
+
+  for (int k = 0; k <= RESPONSE_CURVE_LUT_SIZE; k++) {
+    uint32_t pos = (uint32_t)k * (count - 1) * 256 / RESPONSE_CURVE_LUT_SIZE;  // Q8
+    uint16_t idx = pos >> 8;
+    uint32_t frac = pos & 0xFF;
+    uint16_t y0 = min(points[idx], (uint16_t)32768);
+    uint16_t y1 = (idx + 1 < count) ? min(points[idx + 1], (uint16_t)32768) : y0;
+    responseCurve[k] = (uint16_t)(y0 + (((int32_t)y1 - y0) * (int32_t)frac >> 8));
+  }
+  customCurveActive = true;
+  return true;
 }
 
 void CapacitiveKeyboard::update() {
   if (!isInitialized) return;
-  memcpy(lastKeyIsPressed, keyIsPressed, sizeof(keyIsPressed));
-  pollAllSensorData();
+  // Les masques d'événements ne décrivent que les trames traitées pendant cet appel
+  onsetMask = 0;
+  releaseMask = 0;
+  pressureChangedMask = 0;
+  scanTime_ms = millis();
+  keyProcessingTicks = 0;
 
-  for (int i = 0; i < NUM_KEYS; i++) {
-    uint16_t delta = (baselineData[i] > filteredData[i]) ? (baselineData[i] - filteredData[i]) : 0;
-
-    // --- NOUVELLE MACHINE A ETATS POUR NOTE ON/OFF ---
-    if (!keyIsPressed[i] && delta > pressThresholds[i]) {
-      // --- EVENEMENT NOTE ON ---
-      keyIsPressed[i] = true;
-      pressDeltaStart[i] = delta; // Capture du "Zéro Relatif"
-    } 
-    else if (keyIsPressed[i] && delta < releaseThresholds[i]) {
-      // --- EVENEMENT NOTE OFF ---
-      keyIsPressed[i] = false;
-      // "Retour à Zéro Forcé" : on réinitialise tout l'état de pression
-      slewedPressure[i] = 0.0f;
-      smoothedPressure[i] = 0.0f;
-      for (int j = 0; j < AFTERTOUCH_SMOOTHING_WINDOW_SIZE; j++) {
-        pressureHistory[i][j] = 0.0f;
-      }
-    }
+  // Un capteur par appel, en alternance A/B. Le transfert Wire1 est bloquant (le core n'expose
+  // pas la fin de transfert de l'IIC): la trame lue est traitée dans la foulée.
+  uint8_t s;
+  bool frameRead = scanNextSensor(s);
+  updateStats();
+  if (!frameRead) return;
 
-    // --- Calcul de la pression si la touche est active ---
-    float targetPressure = 0.0f;
-    if (keyIsPressed[i]) {
-      // La plage de pression utile va maintenant du delta de départ au delta max calibré
-      uint16_t maxD = calibrationMaxDelta[i];
-      uint16_t pressD = pressDeltaStart[i] + aftertouchDeadzoneOffset;     
-       float aftertouch_norm = 0.0f;
-      
-      if (maxD > pressD) {
-        // Calcul de la pression normalisée à partir du "Zéro Relatif"
-        aftertouch_norm = (float)((delta > pressD) ? (delta - pressD) : 0) / (float)(maxD - pressD);
-      }
-      if (aftertouch_norm > 1.0f) aftertouch_norm = 1.0f;
-
-      float shaped_norm = 0.0f;
-      float x = aftertouch_norm;
-
-      if (responseShape < 0.5f) {
-        float y_exp = powf(x, AFTERTOUCH_CURVE_EXP_INTENSITY);
-        float y_lin = x;
-        float t = 1.0f - (responseShape * 2.0f);
-        shaped_norm = y_lin * (1.0f - t) + y_exp * t;
-      } else {
-        float y_sig = x * x * (3.0f - 2.0f * x);
-        for (int j = 1; j < AFTERTOUCH_CURVE_SIG_INTENSITY; j++) {
-            y_sig = y_sig * y_sig * (3.0f - 2.0f * y_sig);
-        }
-        float y_lin = x;
-        float t = (responseShape - 0.5f) * 2.0f;
-        shaped_norm = y_lin * (1.0f - t) + y_sig * t;
-      }
-      targetPressure = shaped_norm * (float)CV_OUTPUT_RESOLUTION;
-    }
-    
-    // --- Lissage ETAGE 1: Slew Limiter ---
-    float diff = targetPressure - slewedPressure[i];
-    if (diff > AFTERTOUCH_SLEW_RATE_LIMIT) {
-      slewedPressure[i] += AFTERTOUCH_SLEW_RATE_LIMIT;
-    } else if (diff < -AFTERTOUCH_SLEW_RATE_LIMIT) {
-      slewedPressure[i] -= AFTERTOUCH_SLEW_RATE_LIMIT;
-    } else {
-      slewedPressure[i] = targetPressure;
-    }
+  frameSequence++;
+  frameTimestamp_us = burstTimestamp_us[s];
+  int keyOffset = s * KEYS_PER_SENSOR;
+#if LOOP_PROFILER_ENABLED
+  uint32_t start = cycleCounterNow();
+#endif
+  for (int i = keyOffset; i < keyOffset + KEYS_PER_SENSOR; i++) {
+    processKey(i);
+  }
+#if LOOP_PROFILER_ENABLED
+  keyProcessingTicks = (cycleCounterNow() - start) / KEYS_PER_SENSOR;
+#endif
+}
 
-    // --- Lissage ETAGE 2: Moyenne Mobile ---
-    pressureHistory[i][historyIndex[i]] = slewedPressure[i];
-    historyIndex[i] = (historyIndex[i] + 1) % AFTERTOUCH_SMOOTHING_WINDOW_SIZE;
+void CapacitiveKeyboard::processKey(int i) {
+  uint16_t delta = (baselineData[i] > filteredData[i]) ? (baselineData[i] - filteredData[i]) : 0;
 
-    float sum = 0.0f;
-    for (int j = 0; j < AFTERTOUCH_SMOOTHING_WINDOW_SIZE; j++) {
-      sum += pressureHistory[i][j];
-    }
-    smoothedPressure[i] = sum / (float)AFTERTOUCH_SMOOTHING_WINDOW_SIZE;
+  // --- NOUVELLE MACHINE A ETATS POUR NOTE ON/OFF ---
+  if (!keyIsPressed[i] && delta > pressThresholds[i]) {
+    // --- EVENEMENT NOTE ON ---
+    keyIsPressed[i] = true;
+    pressedMask |= (1UL << i);
+    onsetMask |= (1UL << i);
+    onsetTimestamp_us[i] = frameTimestamp_us; // Instant d'échantillonnage de la trame qui a franchi le seuil
+    pressDeltaStart[i] = delta; // Capture du "Zéro Relatif"
+  } 
+  else if (keyIsPressed[i] && delta < releaseThresholds[i]) {
+    // --- EVENEMENT NOTE OFF ---
+    keyIsPressed[i] = false;
+    pressedMask &= ~(1UL << i);
+    releaseMask |= (1UL << i);
+    // "Retour à Zéro Forcé" : on réinitialise tout l'état de pression
+    pressureChain[i].reset();
+  }
+
+  uint16_t pressD = pressDeltaStart[i] + aftertouchDeadzoneOffset;
+  pressureChain[i].process(keyIsPressed[i], delta, pressD, calibrationMaxDelta[i], responseCurve);
+
+  // --- Publication de l'aftertouch: zone morte + intervalle max ---
+  // Une variation sous la zone morte n'est publiée qu'après AFTERTOUCH_DISPATCH_MAX_INTERVAL_MS,
+  // pour que la valeur finale arrive quand même aux moteurs.
+  uint16_t pressure = pressureChain[i].value();
+  if (!keyIsPressed[i]) {
+    lastPublishedPressure[i] = 0;
+    return;
   }
+  aftertouchCandidatesInWindow++;
+  uint16_t moved = (pressure > lastPublishedPressure[i]) ? pressure - lastPublishedPressure[i]
+                                                         : lastPublishedPressure[i] - pressure;
+  if (moved == 0) return;
+  if (moved >= aftertouchDeadband || (scanTime_ms - lastPublishedTime[i] >= aftertouchMaxInterval_ms)) {
+    lastPublishedPressure[i] = pressure;
+    lastPublishedTime[i] = scanTime_ms;
+    pressureChangedMask |= (1UL << i);
+    aftertouchDispatchesInWindow++;
+  }
+}
+
+uint32_t CapacitiveKeyboard::getFrameSequence() const {
+  return frameSequence;
+}
+
+unsigned long CapacitiveKeyboard::getFrameTimestamp() const {
+  return frameTimestamp_us;
+}
+
+unsigned long CapacitiveKeyboard::getOnsetTimestamp(uint8_t key) const {
+  return (key < NUM_KEYS) ? onsetTimestamp_us[key] : 0;
+}
+
+uint32_t CapacitiveKeyboard::getKeyProcessingTicks() const {
+  return keyProcessingTicks;
 }
 
 bool CapacitiveKeyboard::isPressed(uint8_t note) { if (note >= NUM_KEYS) return false; return keyIsPressed[note]; }
-bool CapacitiveKeyboard::noteOn(uint8_t note)    { if (note >= NUM_KEYS) return false; return keyIsPressed[note] && !lastKeyIsPressed[note]; }
-bool CapacitiveKeyboard::noteOff(uint8_t note)   { if (note >= NUM_KEYS) return false; return !keyIsPressed[note] && lastKeyIsPressed[note]; }
-uint16_t CapacitiveKeyboard::getPressure(uint8_t note) { if (note >= NUM_KEYS) return 0; return (uint16_t)smoothedPressure[note]; }
+bool CapacitiveKeyboard::noteOn(uint8_t note)    { if (note >= NUM_KEYS) return false; return (onsetMask >> note) & 1; }
+bool CapacitiveKeyboard::noteOff(uint8_t note)   { if (note >= NUM_KEYS) return false; return (releaseMask >> note) & 1; }
+uint16_t CapacitiveKeyboard::getPressure(uint8_t note) { if (note >= NUM_KEYS) return 0; return pressureChain[note].value(); }
 const bool* CapacitiveKeyboard::getPressedKeysState() const { return keyIsPressed; }
+uint32_t CapacitiveKeyboard::getPressedMask() const { return pressedMask; }
+uint32_t CapacitiveKeyboard::getOnsetMask() const { return onsetMask; }
+uint32_t CapacitiveKeyboard::getReleaseMask() const { return releaseMask; }
+uint32_t CapacitiveKeyboard::getPressureChangedMask() const { return pressureChangedMask; }
 
 bool CapacitiveKeyboard::initializeHardware() {
   // Wire1 is already initialized in main setup()
@@ -285,22 +386,149 @@ bool CapacitiveKeyboard::runAutoconfiguration(uint16_t targetBaseline) {
 }
 
 void CapacitiveKeyboard::pollAllSensorData() {
-  const uint8_t START_REGISTER = 0x04;
-  const uint8_t BYTES_TO_READ  = 38;
-  uint8_t sensor_addrs[] = { ADDR_MPR121_A, ADDR_MPR121_B };
-  int keyOffset = 0;
+  for (uint8_t s = 0; s < NUM_SENSORS; s++) {
+    readSensorBurst(s);
+  }
+}
 
-  for(uint8_t addr : sensor_addrs) {
-    Wire1.beginTransmission(addr);
-    Wire1.write(START_REGISTER);
-    Wire1.endTransmission(false);
-    if (Wire1.requestFrom(addr, BYTES_TO_READ) == BYTES_TO_READ) {
-      for (int i = 0; i < 12; i++) { filteredData[i + keyOffset] = Wire1.read() | (Wire1.read() << 8); }
-      Wire1.read(); Wire1.read();
-      for (int i = 0; i < 12; i++) { baselineData[i + keyOffset] = Wire1.read() << 2; }
+bool CapacitiveKeyboard::readSensorBurst(uint8_t sensorIndex) {
+  uint8_t addr = SENSOR_ADDRS[sensorIndex];
+  int keyOffset = sensorIndex * KEYS_PER_SENSOR;
+
+  // Horodatage au début du transfert: les données lues sont celles échantillonnées avant
+  // la requête, le temps bus compte donc dans la latence touche -> sortie.
+  unsigned long start_us = micros();
+  Wire1.beginTransmission(addr);
+  Wire1.write(MPR121_FILTERED);
+  Wire1.endTransmission(false);
+  busBytesInWindow += I2C_READ_OVERHEAD + MPR121_BURST_BYTES;
+  if (Wire1.requestFrom(addr, (uint8_t)MPR121_BURST_BYTES) != MPR121_BURST_BYTES) {
+    return false;
+  }
+  for (int i = 0; i < KEYS_PER_SENSOR; i++) {
+    uint8_t lsb = Wire1.read();
+    uint8_t msb = Wire1.read();
+    filteredData[keyOffset + i] = (msb << 8) | lsb;
+  }
+  Wire1.read(); Wire1.read();
+  for (int i = 0; i < KEYS_PER_SENSOR; i++) { baselineData[keyOffset + i] = Wire1.read() << 2; }
+
+  burstTimestamp_us[sensorIndex] = start_us;
+  lastBurstTime[sensorIndex] = millis();
+  return true;
+}
+
+bool CapacitiveKeyboard::readTouchStatus(uint8_t sensorIndex, uint16_t& status) {
+  uint8_t addr = SENSOR_ADDRS[sensorIndex];
+
+  // La lecture du statut acquitte l'IRQ du capteur
+  Wire1.beginTransmission(addr);
+  Wire1.write(MPR121_TOUCH_STATUS);
+  Wire1.endTransmission(false);
+  busBytesInWindow += I2C_READ_OVERHEAD + 2;
+  if (Wire1.requestFrom(addr, (uint8_t)2) != 2) {
+    return false;
+  }
+  uint8_t lsb = Wire1.read();
+  uint8_t msb = Wire1.read();
+  status = ((msb << 8) | lsb) & 0x0FFF;  // Bits 0-11: électrodes (bit 15 = OVCF)
+  return true;
+}
+
+bool CapacitiveKeyboard::sensorHasHeldKey(uint8_t sensorIndex) const {
+  int keyOffset = sensorIndex * KEYS_PER_SENSOR;
+  for (int i = 0; i < KEYS_PER_SENSOR; i++) {
+    if (keyIsPressed[i + keyOffset]) return true;
+  }
+  return false;
+}
+
+bool CapacitiveKeyboard::scanNextSensor(uint8_t& sensorIndex) {
+  // Un seul capteur par appel, en alternance A/B: au plus un burst de 38 octets
+  // (plus le statut en mode IRQ) par appel. true si une trame a été lue.
+  uint8_t s = nextSensor;
+  nextSensor = (nextSensor + 1) % NUM_SENSORS;
+  sensorIndex = s;
+
+  if (scanMode == ScanMode::POLL_ALL) {
+    return readSensorBurst(s);
+  }
+
+  // Fast path: tant que l'IRQ reste haute et qu'aucune touche n'est tenue, le bus reste libre.
+  // La ligne est aussi relue au niveau pour ne pas rater un front pendant une lecture.
+  if (digitalRead(PIN_MPR121_IRQ) == LOW) {
+    sensorIrqPending[s] = true;
+  }
+  bool needBurst = sensorHasHeldKey(s) || (millis() - lastBurstTime[s] >= KEYBOARD_IDLE_REFRESH_MS);
+
+  if (sensorIrqPending[s]) {
+    sensorIrqPending[s] = false;
+    uint16_t status;
+    if (readTouchStatus(s, status)) {
+      if (status != touchStatus[s]) needBurst = true;
+      touchStatus[s] = status;
     }
-    keyOffset += 12;
   }
+  // Le seuil interne du MPR121 est plus bas que nos seuils adaptatifs:
+  // une électrode "touchée" pour le capteur doit être suivie en continu.
+  if (touchStatus[s] != 0) needBurst = true;
+
+  return needBurst && readSensorBurst(s);
+}
+
+void CapacitiveKeyboard::updateStats() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - statsWindowStart;
+  if (elapsed < KEYBOARD_STATS_WINDOW_MS) return;
+
+  busBytesPerSecond = (uint32_t)(((uint64_t)busBytesInWindow * 1000UL) / elapsed);
+  aftertouchCandidatesPerSecond = (uint32_t)(((uint64_t)aftertouchCandidatesInWindow * 1000UL) / elapsed);
+  aftertouchDispatchesPerSecond = (uint32_t)(((uint64_t)aftertouchDispatchesInWindow * 1000UL) / elapsed);
+  busBytesInWindow = 0;
+  aftertouchCandidatesInWindow = 0;
+  aftertouchDispatchesInWindow = 0;
+  statsWindowStart = now;
+
+  #if DEBUG_LEVEL >= 3
+  Serial.print("[I2C] Clavier: ");
+  Serial.print(busBytesPerSecond);
+  Serial.print(" octets/s (mode ");
+  Serial.print(scanMode == ScanMode::IRQ_STATUS ? "IRQ" : "POLL");
+  Serial.println(")");
+  Serial.print("[AT] Dispatch: ");
+  Serial.print(aftertouchDispatchesPerSecond);
+  Serial.print(" / ");
+  Serial.print(aftertouchCandidatesPerSecond);
+  Serial.println(" mises a jour/s");
+  #endif
+}
+
+void CapacitiveKeyboard::setScanMode(ScanMode mode) {
+  // Sans IRQ câblée et configurée, le mode IRQ ne verrait jamais de changement de statut
+  if (!KEYBOARD_IRQ_SCAN_ENABLED) mode = ScanMode::POLL_ALL;
+  scanMode = mode;
+  onSensorIrq();  // Resynchronise les statuts au prochain scan
+}
+
+CapacitiveKeyboard::ScanMode CapacitiveKeyboard::getScanMode() const {
+  return scanMode;
+}
+
+uint32_t CapacitiveKeyboard::getBusBytesPerSecond() const {
+  return busBytesPerSecond;
+}
+
+void CapacitiveKeyboard::setAftertouchDispatch(uint16_t deadband, uint16_t maxInterval_ms) {
+  aftertouchDeadband = deadband > 0 ? deadband : 1;
+  aftertouchMaxInterval_ms = maxInterval_ms;
+}
+
+uint32_t CapacitiveKeyboard::getAftertouchCandidatesPerSecond() const {
+  return aftertouchCandidatesPerSecond;
+}
+
+uint32_t CapacitiveKeyboard::getAftertouchDispatchesPerSecond() const {
+  return aftertouchDispatchesPerSecond;
 }
 
 void CapacitiveKeyboard::saveCalibrationData() {
@@ -3,6 +3,7 @@
 
 #include "KeyboardData.h"
 #include "HardwareConfig.h"
+#include "PressureChain.h"
 #include <stdint.h>
 #include <Wire.h>
 
@@ -13,10 +14,17 @@ class Button;
 
 class CapacitiveKeyboard {
 public:
+  // Stratégie de lecture des capteurs dans update()
+  enum class ScanMode {
+    POLL_ALL,    // Burst complet (38 octets) sur chaque MPR121 à chaque scan
+    IRQ_STATUS   // Statut tactile sur IRQ, burst complet seulement si nécessaire (KEYBOARD_IRQ_SCAN_ENABLED)
+  };
+
   CapacitiveKeyboard();
 
   // API principale
   bool begin();
+  // Lit un capteur (burst Wire1 bloquant, alternance A/B) et traite ses 12 touches
   void update();
 
   // Getters pour l'état des notes
@@ -26,11 +34,41 @@ public:
   uint16_t getPressure(uint8_t note);
   const bool* getPressedKeysState() const;
 
+  // Masques par trame (bit i = touche i): à parcourir avec popLowestKey()
+  uint32_t getPressedMask() const;
+  uint32_t getOnsetMask() const;
+  uint32_t getReleaseMask() const;
+  uint32_t getPressureChangedMask() const;
+
+  // Courbe de réponse de l'aftertouch: table reconstruite seulement quand la forme change
   void setResponseShape(float shape);
+  void setCurveIntensities(float expIntensity, uint8_t sigIntensity);
+  // Courbe utilisateur: points Q15 (32768 = 1.0) répartis uniformément sur la course
+  bool loadResponseCurve(const uint16_t* points, uint16_t count);
   
   // NOUVELLE METHODE: Règle la zone morte de l'aftertouch
   void setAftertouchDeadzone(int offset);
 
+  // Mode de scan et statistiques du bus I2C
+  void setScanMode(ScanMode mode);
+  ScanMode getScanMode() const;
+  uint32_t getBusBytesPerSecond() const;
+
+  // Publication de l'aftertouch vers les moteurs (masque "pression changée")
+  void setAftertouchDispatch(uint16_t deadband, uint16_t maxInterval_ms);
+  uint32_t getAftertouchCandidatesPerSecond() const;   // Touches tenues x trames traitées
+  uint32_t getAftertouchDispatchesPerSecond() const;   // Mises à jour réellement publiées
+
+  // Numéro et horodatage (micros) de la dernière trame capteur traitée.
+  // Un numéro inchangé depuis le tour précédent = données répétées.
+  uint32_t getFrameSequence() const;
+  unsigned long getFrameTimestamp() const;
+  // Horodatage (micros) de la trame qui a déclenché le dernier Note On de la touche
+  unsigned long getOnsetTimestamp(uint8_t key) const;
+  // Coût moyen de processKey() par touche sur la trame traitée par le dernier update(), en ticks
+  // de cycleCounterNow() (0 = pas de trame, ou LOOP_PROFILER_ENABLED à 0)
+  uint32_t getKeyProcessingTicks() const;
+
   // API pour Outils Externes
   bool initializeHardware();
   bool runAutoconfiguration(uint16_t targetBaseline);
@@ -46,14 +84,36 @@ public:
 
 
 private:
+  static const uint8_t NUM_SENSORS = 2;
+  static const uint8_t KEYS_PER_SENSOR = 12;
+
   void writeRegister(uint8_t addr, uint8_t reg, uint8_t value);
   uint8_t readRegister(uint8_t addr, uint8_t reg);
 
+  // Lecture des capteurs: un burst Wire1 bloquant, un capteur par update()
+  bool scanNextSensor(uint8_t& sensorIndex);
+  bool readSensorBurst(uint8_t sensorIndex);
+  void processKey(int i);
+  void rebuildResponseCurve();
+  bool readTouchStatus(uint8_t sensorIndex, uint16_t& status);
+  bool sensorHasHeldKey(uint8_t sensorIndex) const;
+  void updateStats();
+  static void onSensorIrq();
+
+  static volatile bool sensorIrqPending[NUM_SENSORS];
+
   uint16_t filteredData[NUM_KEYS];
   uint16_t baselineData[NUM_KEYS];
-  float    smoothedPressure[NUM_KEYS];
   bool     keyIsPressed[NUM_KEYS];
-  bool     lastKeyIsPressed[NUM_KEYS];
+  uint16_t lastPublishedPressure[NUM_KEYS];
+  unsigned long lastPublishedTime[NUM_KEYS];
+  unsigned long scanTime_ms;
+  uint16_t aftertouchDeadband;
+  uint16_t aftertouchMaxInterval_ms;
+  uint32_t pressedMask;
+  uint32_t onsetMask;
+  uint32_t releaseMask;
+  uint32_t pressureChangedMask;
   bool     isInitialized;
 
   uint16_t currentTargetBaseline;
@@ -62,15 +122,40 @@ private:
   uint16_t releaseThresholds[NUM_KEYS];
   
   float responseShape;
+  float   curveExpIntensity;
+  uint8_t curveSigIntensity;
+  bool    customCurveActive;
+  uint16_t responseCurve[RESPONSE_CURVE_LUT_SIZE + 1];  // Q15, +1 pour l'interpolation du dernier segment
 
   // NOUVELLE VARIABLE: Stocke l'offset de la zone morte
   int aftertouchDeadzoneOffset;
 
   // Variables pour le lissage et la nouvelle logique de pression
   uint16_t pressDeltaStart[NUM_KEYS];
-  float slewedPressure[NUM_KEYS];
-  float pressureHistory[NUM_KEYS][AFTERTOUCH_SMOOTHING_WINDOW_SIZE];
-  int   historyIndex[NUM_KEYS];
+  PressureChain pressureChain[NUM_KEYS];  // Fixe ou flottante selon AFTERTOUCH_FIXED_POINT
+
+  // État du scan piloté par IRQ
+  ScanMode scanMode;
+  uint16_t touchStatus[NUM_SENSORS];
+  unsigned long lastBurstTime[NUM_SENSORS];
+
+  unsigned long burstTimestamp_us[NUM_SENSORS];  // Début du transfert du dernier burst
+  uint8_t  nextSensor;
+  uint32_t frameSequence;
+  uint32_t keyProcessingTicks;
+  unsigned long frameTimestamp_us;
+  unsigned long onsetTimestamp_us[NUM_KEYS];
+
+  // Compteurs sur fenêtre glissante: octets sur le bus (adresse + registre + données)
+  uint32_t busBytesInWindow;
+  uint32_t busBytesPerSecond;
+  unsigned long statsWindowStart;
+
+  // Compteurs de publication de l'aftertouch
+  uint32_t aftertouchCandidatesInWindow;
+  uint32_t aftertouchDispatchesInWindow;
+  uint32_t aftertouchCandidatesPerSecond;
+  uint32_t aftertouchDispatchesPerSecond;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "ControlScheduler.h"
+#include <FspTimer.h>
+
+// Base de temps: seul état partagé avec l'interruption (lecture 32 bits atomique sur Cortex-M4)
+static FspTimer tickTimer;
+static volatile uint32_t schedulerTicks = 0;
+
+static void onSchedulerTick(timer_callback_args_t* args) {
+  (void)args;
+  schedulerTicks++;
+}
+
+ControlScheduler::ControlScheduler() {
+  _taskCount = 0;
+  _tickPeriod_us = 1000;
+  _statsStart_ms = 0;
+}
+
+bool ControlScheduler::begin(uint32_t tickHz) {
+  if (tickHz == 0) return false;
+  _tickPeriod_us = 1000000UL / tickHz;
+
+  uint8_t timerType;
+  int8_t channel = FspTimer::get_available_timer(timerType);
+  if (channel < 0) {
+    #if DEBUG_LEVEL >= 0
+    Serial.println("FATAL: Aucun timer libre pour l'ordonnanceur");
+    #endif
+    return false;
+  }
+  if (!tickTimer.begin(TIMER_MODE_PERIODIC, timerType, channel, (float)tickHz, 0.0f, onSchedulerTick) ||
+      !tickTimer.setup_overflow_irq() || !tickTimer.open() || !tickTimer.start()) {
+    #if DEBUG_LEVEL >= 0
+    Serial.println("FATAL: Demarrage du timer de l'ordonnanceur impossible");
+    #endif
+    return false;
+  }
+
+  resetStats();
+
+  #if DEBUG_LEVEL >= 0
+  Serial.print("INFO: Ordonnanceur demarre, tick ");
+  Serial.print(_tickPeriod_us);
+  Serial.println(" us");
+  #endif
+  return true;
+}
+
+int8_t ControlScheduler::addTask(const char* name, SchedulerTaskFn fn, uint32_t period_us) {
+  if (_taskCount >= MAX_TASKS || fn == nullptr) return -1;
+  Task& task = _tasks[_taskCount];
+  task.name = name;
+  task.fn = fn;
+  task.periodTicks = (period_us + _tickPeriod_us / 2) / _tickPeriod_us;
+  if (task.periodTicks == 0) task.periodTicks = 1;
+  task.dueTick = schedulerTicks;
+  task.runs = 0;
+  task.missed = 0;
+  task.overruns = 0;
+  task.maxLate_us = 0;
+  task.maxDuration_us = 0;
+  task.totalDuration_us = 0;
+  return (int8_t)_taskCount++;
+}
+
+uint32_t ControlScheduler::getTicks() const {
+  return schedulerTicks;
+}
+
+uint8_t ControlScheduler::run() {
+  uint8_t ran = 0;
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    Task& task = _tasks[i];
+    uint32_t late = schedulerTicks - task.dueTick;
+    if ((int32_t)late < 0) continue;
+
+    // Périodes entières écoulées sans exécution: échéances ratées, on se recale sur la grille
+    if (late >= task.periodTicks) {
+      uint32_t skipped = late / task.periodTicks;
+      task.missed += skipped;
+      task.dueTick += skipped * task.periodTicks;
+    }
+    task.dueTick += task.periodTicks;
+
+    uint32_t late_us = late * _tickPeriod_us;
+    if (late_us > task.maxLate_us) task.maxLate_us = late_us;
+
+    unsigned long start = micros();
+    task.fn();
+    uint32_t duration_us = micros() - start;
+
+    task.runs++;
+    task.totalDuration_us += duration_us;
+    if (duration_us > task.maxDuration_us) task.maxDuration_us = duration_us;
+    if (duration_us > task.periodTicks * _tickPeriod_us) task.overruns++;
+    ran++;
+  }
+  return ran;
+}
+
+bool ControlScheduler::handleCommand(int command) {
+  if (command == LOOP_PROFILER_DUMP_COMMAND) {
+    dump(Serial);
+    return true;
+  }
+  if (command == LOOP_PROFILER_RESET_COMMAND) {
+    resetStats();
+    return true;
+  }
+  return false;
+}
+
+void ControlScheduler::resetStats() {
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    Task& task = _tasks[i];
+    task.runs = 0;
+    task.missed = 0;
+    task.overruns = 0;
+    task.maxLate_us = 0;
+    task.maxDuration_us = 0;
+    task.totalDuration_us = 0;
+  }
+  _statsStart_ms = millis();
+}
+
+void ControlScheduler::dump(Print& out) const {
+  unsigned long elapsed_ms = millis() - _statsStart_ms;
+  out.print("--- Ordonnanceur: tick ");
+  out.print(_tickPeriod_us);
+  out.print(" us, ");
+  out.print(elapsed_ms);
+  out.println(" ms mesurees ---");
+  out.println("tache      per(us)\tn\tratees\tdepass.\tretard max(us)\tmoy(us)\tmax(us)\tcharge(%)");
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    const Task& task = _tasks[i];
+    out.print(task.name);
+    for (size_t pad = strlen(task.name); pad < 11; pad++) out.print(' ');
+    out.print(task.periodTicks * _tickPeriod_us);
+    out.print('\t');
+    out.print(task.runs);
+    out.print('\t');
+    out.print(task.missed);
+    out.print('\t');
+    out.print(task.overruns);
+    out.print('\t');
+    out.print(task.maxLate_us);
+    out.print("\t\t");
+    out.print(task.runs ? (float)task.totalDuration_us / task.runs : 0.0f);
+    out.print('\t');
+    out.print(task.maxDuration_us);
+    out.print('\t');
+    out.println(elapsed_ms ? (float)task.totalDuration_us / (elapsed_ms * 10.0f) : 0.0f);
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef CONTROL_SCHEDULER_H
+#define CONTROL_SCHEDULER_H
+
+#include <Arduino.h>
+#include "HardwareConfig.h"
+
+typedef void (*SchedulerTaskFn)();
+
+/**
+ * Ordonnanceur coopératif à cadence fixe.
+ *
+ * - Un timer matériel (FspTimer) incrémente un compteur de ticks en interruption, rien d'autre
+ * - run(), appelé par loop(), exécute chaque tâche échue dans l'ordre d'enregistrement;
+ *   une tâche n'est jamais interrompue par une autre
+ * - Échéance ratée: la tâche démarre alors qu'une ou plusieurs périodes complètes sont déjà
+ *   écoulées depuis son échéance. Les périodes sautées sont comptées, pas rattrapées en rafale
+ * - Dépassement de budget: une exécution plus longue que la période de la tâche
+ */
+class ControlScheduler {
+public:
+  static const uint8_t MAX_TASKS = 6;
+
+  ControlScheduler();
+
+  /**
+   * @brief Démarre la base de temps matérielle.
+   * @return false si aucun timer n'est disponible.
+   */
+  bool begin(uint32_t tickHz);
+
+  /**
+   * @brief Ajoute une tâche de période period_us (arrondie à un multiple du tick), après begin().
+   * La première exécution a lieu au prochain run().
+   * @return Identifiant de la tâche, -1 si la table est pleine.
+   */
+  int8_t addTask(const char* name, SchedulerTaskFn fn, uint32_t period_us);
+
+  /**
+   * @brief Exécute les tâches échues.
+   * @return Nombre de tâches exécutées pendant cet appel.
+   */
+  uint8_t run();
+
+  uint32_t getTicks() const;
+  uint32_t getTickPeriodMicros() const { return _tickPeriod_us; }
+
+  // --- Compteurs par tâche (depuis le dernier resetStats) ---
+  uint32_t getRunCount(int8_t task) const      { return isValid(task) ? _tasks[task].runs : 0; }
+  uint32_t getMissedDeadlines(int8_t task) const { return isValid(task) ? _tasks[task].missed : 0; }
+  uint32_t getOverruns(int8_t task) const      { return isValid(task) ? _tasks[task].overruns : 0; }
+  uint32_t getMaxLateMicros(int8_t task) const { return isValid(task) ? _tasks[task].maxLate_us : 0; }
+  uint32_t getMaxDurationMicros(int8_t task) const { return isValid(task) ? _tasks[task].maxDuration_us : 0; }
+
+  /**
+   * @brief Même protocole que LoopProfiler::handleCommand() (mêmes octets de commande).
+   */
+  bool handleCommand(int command);
+  void resetStats();
+  void dump(Print& out) const;
+
+private:
+  struct Task {
+    const char*     name;
+    SchedulerTaskFn fn;
+    uint32_t        periodTicks;
+    uint32_t        dueTick;
+    uint32_t        runs;
+    uint32_t        missed;
+    uint32_t        overruns;
+    uint32_t        maxLate_us;
+    uint32_t        maxDuration_us;
+    uint64_t        totalDuration_us;
+  };
+
+  bool isValid(int8_t task) const { return task >= 0 && task < _taskCount; }
+
+  Task _tasks[MAX_TASKS];
+  uint8_t _taskCount;
+  uint32_t _tickPeriod_us;
+  unsigned long _statsStart_ms;
+};
+
+#endif // CONTROL_SCHEDULER_H
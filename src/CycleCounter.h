@@ -0,0 +1,51 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+/**
+ * Compteur de cycles pour le profilage.
+ *
+ * - Cible (Cortex-M4): registre DWT->CYCCNT, 1 tick = 1 cycle CPU
+ * - PC (KEYBOARD_NATIVE): horloge monotone haute résolution, 1 tick = 1 ns
+ *   (temps CPU réel du PC: le temps bus I2C simulé n'y apparaît pas)
+ *
+ * Le compteur est 32 bits et reboucle: seules les différences courtes ont un sens.
+ */
+
+#ifdef KEYBOARD_NATIVE
+
+#include <chrono>
+
+inline void cycleCounterBegin() {}
+
+inline uint32_t cycleCounterNow() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint32_t cycleCounterHz() {
+  return 1000000000UL;
+}
+
+#else
+
+#include <Arduino.h>
+
+inline void cycleCounterBegin() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline uint32_t cycleCounterNow() {
+  return DWT->CYCCNT;
+}
+
+inline uint32_t cycleCounterHz() {
+  return SystemCoreClock;
+}
+
+#endif
+
+#endif // CYCLE_COUNTER_H
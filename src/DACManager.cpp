@@ -2,8 +2,29 @@
 #include "HardwareConfig.h"
 #include <DFRobot_GP8403.h>
 
+// Registres de données du GP8403: code 12 bits aligné à gauche (<< 4), LSB d'abord
+#define GP8403_REG_CHANNEL0 0x02
+#define GP8403_REG_CHANNEL1 0x04
+// Octets sur le bus: adresse + registre + 2 octets par canal
+#define DAC_SINGLE_WRITE_BYTES 4
+#define DAC_DUAL_WRITE_BYTES   6
+
 DACManager::DACManager() {
   _dac = nullptr;
+  _wire = nullptr;
+  _i2cAddr = 0;
+  _lastCode[0] = NO_CODE;
+  _lastCode[1] = NO_CODE;
+  for (uint8_t channel = 0; channel < 2; channel++) {
+    setChannelCalibration(channel, DAC_DEFAULT_OFFSET_CODE, DAC_DEFAULT_CODES_PER_VOLT);
+  }
+  _writesInWindow = 0;
+  _busBytesInWindow = 0;
+  _requestedBytesInWindow = 0;
+  _writesPerSecond = 0;
+  _busBytesPerSecond = 0;
+  _savedBusBytesPerSecond = 0;
+  _statsWindowStart = 0;
 }
 
 DACManager::~DACManager() {
@@ -20,6 +41,8 @@ bool DACManager::begin(uint8_t i2cAddr, TwoWire &wirePort) {
   Serial.println("...");
   #endif
 
+  _wire = &wirePort;
+  _i2cAddr = i2cAddr;
   if (!_dac) {
     _dac = new DFRobot_GP8403(&wirePort, i2cAddr);
     #if DEBUG_LEVEL >= 0
@@ -64,6 +87,8 @@ bool DACManager::begin(uint8_t i2cAddr, TwoWire &wirePort) {
   // Test initial - set both outputs to 0V
   _dac->setDACOutVoltage(0, 0);  // Channel 0 to 0V
   _dac->setDACOutVoltage(0, 1);  // Channel 1 to 0V
+  _lastCode[0] = 0;
+  _lastCode[1] = 0;
   delay(50);  // Allow initial output to stabilize
   
   #if DEBUG_LEVEL >= 0
@@ -73,15 +98,134 @@ bool DACManager::begin(uint8_t i2cAddr, TwoWire &wirePort) {
   return true;
 }
 
+void DACManager::setChannelCalibration(uint8_t channel, int16_t offsetCode, float codesPerVolt) {
+  if (channel > 1) return;
+  _offsetCode[channel] = offsetCode;
+  _codesPerVolt[channel] = codesPerVolt;
+  // Gain entier précalculé pour le chemin millivolts: codes par mV en Q16
+  _codesPerMillivolt_q16[channel] = (int32_t)(codesPerVolt * 65536.0f / 1000.0f + 0.5f);
+}
+
+uint16_t DACManager::voltsToCode(uint8_t channel, float volts) const {
+  // Une multiplication-addition et un arrondi au plus proche, bornés à la plage du DAC
+  float code = _offsetCode[channel] + volts * _codesPerVolt[channel] + 0.5f;
+  if (code <= 0.0f) return 0;
+  if (code >= (float)CV_OUTPUT_RESOLUTION) return CV_OUTPUT_RESOLUTION;
+  return (uint16_t)code;
+}
+
+uint16_t DACManager::millivoltsToCode(uint8_t channel, int32_t millivolts) const {
+  int32_t code = _offsetCode[channel] + (int32_t)(((int64_t)millivolts * _codesPerMillivolt_q16[channel] + 32768) >> 16);
+  if (code <= 0) return 0;
+  if (code >= CV_OUTPUT_RESOLUTION) return CV_OUTPUT_RESOLUTION;
+  return (uint16_t)code;
+}
+
 void DACManager::setOutputVoltage(uint8_t channel, float voltage) {
+  if (channel > 1) {
+    return;
+  }
+  setOutputCode(channel, voltsToCode(channel, voltage));
+}
+
+void DACManager::setOutputVoltages(float pitchVoltage, float auxVoltage) {
+  setOutputCodes(voltsToCode(0, pitchVoltage), voltsToCode(1, auxVoltage));
+}
+
+void DACManager::setOutputCode(uint8_t channel, uint16_t code) {
   if (!_dac || channel > 1) {
     return;
   }
+  _requestedBytesInWindow += DAC_SINGLE_WRITE_BYTES;
 
-  // La bibliothèque attend une valeur en millivolts.
-  float clampedVoltage = constrain(voltage, 0.0f, DAC_OUTPUT_VOLTAGE_RANGE);
-  uint16_t millivolts = clampedVoltage * 1000;
+  if (code > CV_OUTPUT_RESOLUTION) code = CV_OUTPUT_RESOLUTION;
+  if (code != _lastCode[channel]) {
+    writeChannel(channel, code);
+  }
+  updateStats();
+}
 
-  // Met à jour la tension dans le registre volatile (RAM) du DAC.
-  _dac->setDACOutVoltage(millivolts, channel);
-}
\ No newline at end of file
+void DACManager::setOutputCodes(uint16_t code0, uint16_t code1) {
+  if (!_dac) {
+    return;
+  }
+  _requestedBytesInWindow += 2 * DAC_SINGLE_WRITE_BYTES;
+
+  if (code0 > CV_OUTPUT_RESOLUTION) code0 = CV_OUTPUT_RESOLUTION;
+  if (code1 > CV_OUTPUT_RESOLUTION) code1 = CV_OUTPUT_RESOLUTION;
+  bool changed0 = (code0 != _lastCode[0]);
+  bool changed1 = (code1 != _lastCode[1]);
+  if (changed0 && changed1) {
+    writeBothChannels(code0, code1);
+  } else if (changed0) {
+    writeChannel(0, code0);
+  } else if (changed1) {
+    writeChannel(1, code1);
+  }
+  updateStats();
+}
+
+void DACManager::writeChannel(uint8_t channel, uint16_t code) {
+  uint16_t data = code << 4;
+  _wire->beginTransmission(_i2cAddr);
+  _wire->write(channel == 0 ? GP8403_REG_CHANNEL0 : GP8403_REG_CHANNEL1);
+  _wire->write((uint8_t)(data & 0xFF));
+  _wire->write((uint8_t)(data >> 8));
+  _wire->endTransmission();
+  _lastCode[channel] = code;
+  _writesInWindow++;
+  _busBytesInWindow += DAC_SINGLE_WRITE_BYTES;
+}
+
+void DACManager::writeBothChannels(uint16_t code0, uint16_t code1) {
+  uint16_t data0 = code0 << 4;
+  uint16_t data1 = code1 << 4;
+  _wire->beginTransmission(_i2cAddr);
+  _wire->write(GP8403_REG_CHANNEL0);
+  _wire->write((uint8_t)(data0 & 0xFF));
+  _wire->write((uint8_t)(data0 >> 8));
+  _wire->write((uint8_t)(data1 & 0xFF));
+  _wire->write((uint8_t)(data1 >> 8));
+  _wire->endTransmission();
+  _lastCode[0] = code0;
+  _lastCode[1] = code1;
+  _writesInWindow++;
+  _busBytesInWindow += DAC_DUAL_WRITE_BYTES;
+}
+
+void DACManager::updateStats() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - _statsWindowStart;
+  if (elapsed < DAC_STATS_WINDOW_MS) return;
+
+  uint32_t saved = (_requestedBytesInWindow > _busBytesInWindow) ? _requestedBytesInWindow - _busBytesInWindow : 0;
+  _writesPerSecond = (uint32_t)(((uint64_t)_writesInWindow * 1000UL) / elapsed);
+  _busBytesPerSecond = (uint32_t)(((uint64_t)_busBytesInWindow * 1000UL) / elapsed);
+  _savedBusBytesPerSecond = (uint32_t)(((uint64_t)saved * 1000UL) / elapsed);
+  _writesInWindow = 0;
+  _busBytesInWindow = 0;
+  _requestedBytesInWindow = 0;
+  _statsWindowStart = now;
+
+  #if DEBUG_LEVEL >= 3
+  Serial.print("[I2C] DAC: ");
+  Serial.print(_writesPerSecond);
+  Serial.print(" ecritures/s, ");
+  Serial.print(_busBytesPerSecond);
+  Serial.print(" octets/s (");
+  Serial.print(_savedBusBytesPerSecond);
+  Serial.println(" octets/s evites)");
+  #endif
+}
+
+uint32_t DACManager::getWritesPerSecond() const {
+  return _writesPerSecond;
+}
+
+uint32_t DACManager::getBusBytesPerSecond() const {
+  return _busBytesPerSecond;
+}
+
+uint32_t DACManager::getSavedBusBytesPerSecond() const {
+  return _savedBusBytesPerSecond;
+}
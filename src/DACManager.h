@@ -24,13 +24,64 @@ public:
 
   /**
    * @brief Définit la tension de sortie pour un canal donné.
+   * Convertie par la calibration du canal; aucune écriture I2C si le code n'a pas changé.
    * @param channel Le canal à modifier (0 pour Pitch, 1 pour Aux).
    * @param voltage La tension cible en Volts.
    */
   void setOutputVoltage(uint8_t channel, float voltage);
 
+  /**
+   * @brief Définit les deux canaux en une seule fois (rendu de la boucle principale).
+   * Seuls les canaux dont le code a changé sont écrits; si les deux ont changé,
+   * une seule transaction de 4 octets de données (0x02 puis 0x04, auto-incrément).
+   */
+  void setOutputVoltages(float pitchVoltage, float auxVoltage);
+
+  /**
+   * @brief Chemin entier: code 12 bits (0-4095) écrit tel quel, mêmes règles de
+   * changement et de regroupement que les variantes en volts.
+   */
+  void setOutputCode(uint8_t channel, uint16_t code);
+  void setOutputCodes(uint16_t code0, uint16_t code1);
+
+  /**
+   * @brief Calibration volts -> code d'un canal: code = offset + tension x gain.
+   * Le gain est aussi précalculé en Q16 (codes par mV) pour millivoltsToCode().
+   */
+  void setChannelCalibration(uint8_t channel, int16_t offsetCode, float codesPerVolt);
+  uint16_t voltsToCode(uint8_t channel, float volts) const;
+  uint16_t millivoltsToCode(uint8_t channel, int32_t millivolts) const;
+
+  // Compteurs sur DAC_STATS_WINDOW_MS, ramenés à la seconde
+  uint32_t getWritesPerSecond() const;          // Transactions I2C réellement émises
+  uint32_t getBusBytesPerSecond() const;        // Adresse + registre + données
+  uint32_t getSavedBusBytesPerSecond() const;   // Par rapport à une transaction par appel
+
 private:
+  void writeChannel(uint8_t channel, uint16_t code);
+  void writeBothChannels(uint16_t code0, uint16_t code1);
+  void updateStats();
+
   DFRobot_GP8403* _dac;
+  TwoWire* _wire;
+  uint8_t _i2cAddr;
+
+  // Dernier code écrit par canal (NO_CODE = inconnu, la prochaine écriture part forcément)
+  static const uint16_t NO_CODE = 0xFFFF;
+  uint16_t _lastCode[2];
+
+  // Calibration par canal
+  int16_t _offsetCode[2];
+  float   _codesPerVolt[2];
+  int32_t _codesPerMillivolt_q16[2];
+
+  uint32_t _writesInWindow;
+  uint32_t _busBytesInWindow;
+  uint32_t _requestedBytesInWindow;
+  uint32_t _writesPerSecond;
+  uint32_t _busBytesPerSecond;
+  uint32_t _savedBusBytesPerSecond;
+  unsigned long _statsWindowStart;
 };
 
-#endif // DAC_MANAGER_H
\ No newline at end of file
+#endif // DAC_MANAGER_H
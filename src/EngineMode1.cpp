@@ -8,15 +8,20 @@ EngineMode1::EngineMode1() {
   _octaveOffset = 0;
   _latchEnabled = false;
   _noteStackPointer = -1;
-  _currentPitchVoltage = PITCH_CV_CENTER_VOLTAGE;
-  _targetPitchVoltage = PITCH_CV_CENTER_VOLTAGE;
-  _lastActivePitchVoltage = PITCH_CV_CENTER_VOLTAGE;
+  _pitchCal = nullptr;
+  _currentPitchCode = 0.0f;
+  _targetPitchCode = 0;
+  _lastActivePitchCode = 0;
   _currentAuxVoltage = 0.0f;
   _targetAuxVoltage = 0.0f;
-  _auxSmoothingAlpha = AUX_VOLTAGE_SMOOTHING_ALPHA_DEFAULT;
+  // Cran de l'encodeur le plus proche de la valeur par défaut (échelle géométrique MIN..MAX)
+  setAuxSmoothingStep((int)(AUX_SMOOTHING_ENCODER_STEPS * logf(AUX_SMOOTHING_TIME_DEFAULT_MS / AUX_SMOOTHING_MIN_TIME_MS) /
+                            logf(AUX_SMOOTHING_MAX_TIME_MS / AUX_SMOOTHING_MIN_TIME_MS) + 0.5f));
   _glideTime_ms = 0.0f;
   _gateOpen = false;
   _retriggerEvent = false;
+  _pendingOnset_us = 0;
+  _outputOnset_us = 0;
   _lastUpdateTime_micros = 0;
   _uiEffectRequested = UIEffect::NONE;
   _livePotDisplayValue = 0;
@@ -28,7 +33,11 @@ EngineMode1::EngineMode1() {
   }
 }
 
-void EngineMode1::begin() {
+void EngineMode1::begin(const PitchCalibration& pitchCal) {
+  _pitchCal = &pitchCal;
+  _targetPitchCode = _pitchCal->noteToCode(PITCH_REFERENCE_MIDI_NOTE);
+  _lastActivePitchCode = _targetPitchCode;
+  _currentPitchCode = _targetPitchCode;
   _lastUpdateTime_micros = micros();
   updateNotePriority();
 }
@@ -50,72 +59,78 @@ void EngineMode1::update() {
 
   if (_glideTime_ms > 5.0f) {
     float alpha = 1.0f - expf(-deltaTime_ms / _glideTime_ms);
-    _currentPitchVoltage = (1.0f - alpha) * _currentPitchVoltage + alpha * _targetPitchVoltage;
+    _currentPitchCode = (1.0f - alpha) * _currentPitchCode + alpha * _targetPitchCode;
   } else {
-    _currentPitchVoltage = _targetPitchVoltage;
+    _currentPitchCode = _targetPitchCode;
   }
   
-  _currentAuxVoltage = (1.0f - _auxSmoothingAlpha) * _currentAuxVoltage + _auxSmoothingAlpha * _targetAuxVoltage;
+  _currentAuxVoltage = _auxSmoother.process(_targetAuxVoltage, deltaTime_micros);
 }
 
-void EngineMode1::processInputs(const InputEvents& events, const bool* physicalKeyState) {
-  // Shift mode detection
-  bool shiftPlus = events.octPlus_isLongPressed;
-  bool shiftMinus = events.octMinus_isLongPressed;
+void EngineMode1::handleInput(const InputEvent& event, const bool* physicalKeyState) {
+  switch (event.type) {
+    // --- Button Events ---
+    case InputEventType::HOLD_SHORT:
+      setLatch(!_latchEnabled, physicalKeyState);
+      _uiEffectRequested = UIEffect::VALIDATE;
+      break;
+    case InputEventType::OCT_PLUS_SHORT:
+      if (_octaveOffset < MAX_OCTAVE) _octaveOffset++;
+      updateNotePriority();
+      break;
+    case InputEventType::OCT_MINUS_SHORT:
+      if (_octaveOffset > MIN_OCTAVE) _octaveOffset--;
+      updateNotePriority();
+      break;
 
-  // --- Button Events ---
-  if (events.hold_wasPressedShort) {
-    setLatch(!_latchEnabled, physicalKeyState);
-    _uiEffectRequested = UIEffect::VALIDATE;
-  }
-  if (events.octPlus_wasReleasedAsShort) {
-    if (_octaveOffset < MAX_OCTAVE) _octaveOffset++;
-    updateNotePriority();
-  }
-  if (events.octMinus_wasReleasedAsShort) {
-    if (_octaveOffset > MIN_OCTAVE) _octaveOffset--;
-    updateNotePriority();
-  }
+    // --- Encoder Control (Incremental), shift state taken from the event ---
+    case InputEventType::ENCODER:
+      if (event.modifiers & INPUT_MOD_SHIFT_PLUS) {
+        // Direct smoothing control - no catching needed!
+        setAuxSmoothingStep(_auxSmoothingStep + event.value);
+      }
+      else if (event.modifiers & INPUT_MOD_SHIFT_MINUS) {
+        // Direct deadzone control - no catching needed!
+        int step = AFTERTOUCH_DEADZONE_MAX_OFFSET / 50; // 50 steps from 0 to max
+        _aftertouchDeadzoneOffset = constrain(
+          _aftertouchDeadzoneOffset + (event.value * step),
+          0, AFTERTOUCH_DEADZONE_MAX_OFFSET
+        );
+      }
+      else {
+        // Glide control with velocity-based smooth acceleration
+        float stepSize = calculateEncoderStep(
+          event.velocity,
+          GLIDE_STEP_MIN,
+          GLIDE_STEP_MAX,
+          GLIDE_ACCEL_CURVE
+        );
+        
+        _glideTime_ms = constrain(
+          _glideTime_ms + (event.value * stepSize),
+          0.0f, GLIDE_MAX_TIME_MS
+        );
+        _livePotDisplayValue = (_glideTime_ms / GLIDE_MAX_TIME_MS) * 100;
+      }
+      break;
 
-  // --- Encoder Control (Incremental) ---
-  if (shiftPlus && events.live_encoderTurned) {
-    // Direct smoothing control - no catching needed!
-    float step = (AUX_SMOOTHING_MAX_ALPHA - AUX_SMOOTHING_MIN_ALPHA) / 100.0f;
-    float newAlpha = _auxSmoothingAlpha + (events.live_encoderDelta * step);
-    setAuxSmoothingAlpha(constrain(newAlpha, AUX_SMOOTHING_MIN_ALPHA, AUX_SMOOTHING_MAX_ALPHA));
-  } 
-  else if (shiftMinus && events.live_encoderTurned) {
-    // Direct deadzone control - no catching needed!
-    int step = AFTERTOUCH_DEADZONE_MAX_OFFSET / 50; // 50 steps from 0 to max
-    _aftertouchDeadzoneOffset = constrain(
-      _aftertouchDeadzoneOffset + (events.live_encoderDelta * step),
-      0, AFTERTOUCH_DEADZONE_MAX_OFFSET
-    );
-  }
-  else if (events.live_encoderTurned) {
-    // Glide control with velocity-based smooth acceleration
-    float stepSize = calculateEncoderStep(
-      events.live_encoderVelocity,
-      GLIDE_STEP_MIN,
-      GLIDE_STEP_MAX,
-      GLIDE_ACCEL_CURVE
-    );
-    
-    _glideTime_ms = constrain(
-      _glideTime_ms + (events.live_encoderDelta * stepSize),
-      0.0f, GLIDE_MAX_TIME_MS
-    );
-    _livePotDisplayValue = (_glideTime_ms / GLIDE_MAX_TIME_MS) * 100;
+    default:
+      break;
   }
 }
 
-void EngineMode1::setAuxSmoothingAlpha(float alpha) {
-  _auxSmoothingAlpha = constrain(alpha, AUX_SMOOTHING_MIN_ALPHA, AUX_SMOOTHING_MAX_ALPHA);
+void EngineMode1::setAuxSmoothingStep(int step) {
+  // Chaque cran multiplie la constante de temps par le même facteur (hors chemin critique: powf)
+  _auxSmoothingStep = constrain(step, 0, AUX_SMOOTHING_ENCODER_STEPS);
+  float position = (float)_auxSmoothingStep / AUX_SMOOTHING_ENCODER_STEPS;
+  _auxSmoother.setTimeConstant(AUX_SMOOTHING_MIN_TIME_MS *
+                               powf(AUX_SMOOTHING_MAX_TIME_MS / AUX_SMOOTHING_MIN_TIME_MS, position));
 }
 
-void EngineMode1::onNoteOn(uint8_t pitch, uint16_t value) {
+void EngineMode1::onNoteOn(uint8_t pitch, uint16_t value, unsigned long onsetTime_us) {
   _gateOpen = true;
   _retriggerEvent = true;
+  if (_pendingOnset_us == 0) _pendingOnset_us = onsetTime_us;
   pushNote(pitch, value);
   updateNotePriority();
 }
@@ -135,6 +150,7 @@ void EngineMode1::onAftertouchUpdate(uint8_t keyIndex, uint16_t pressure) {
   
   // Check if this is the active note first (most common case)
   if (_noteStack[_noteStackPointer].pitch == targetPitch) {
+    if (_noteStack[_noteStackPointer].value == pressure) return;  // Rien à recalculer
     _noteStack[_noteStackPointer].value = pressure;
     updateNotePriority();  // Update output immediately for active note
     return;
@@ -151,15 +167,22 @@ void EngineMode1::onAftertouchUpdate(uint8_t keyIndex, uint16_t pressure) {
 }
 
 
-float EngineMode1::getPitchVoltage() const { return _currentPitchVoltage; }
+uint16_t EngineMode1::getPitchCode() const { return (uint16_t)(_currentPitchCode + 0.5f); }
 float EngineMode1::getAuxVoltage() const { return _currentAuxVoltage; }
 bool EngineMode1::getGateState() const { return _gateOpen; }
 int EngineMode1::getOctaveOffset() const { return _octaveOffset; }
 bool EngineMode1::isLatchActive() const { return _latchEnabled; }
 int EngineMode1::getLivePotDisplayValue() const { return _livePotDisplayValue; }
 int EngineMode1::getAftertouchDeadzoneOffset() const { return _aftertouchDeadzoneOffset; }
-float EngineMode1::getAuxSmoothingAlpha() const { return _auxSmoothingAlpha; }
-bool EngineMode1::getAndClearRetriggerEvent() { bool e = _retriggerEvent; _retriggerEvent = false; return e; }
+float EngineMode1::getAuxSmoothingTime() const { return _auxSmoother.getTimeConstant(); }
+bool EngineMode1::getAndClearRetriggerEvent() {
+  bool e = _retriggerEvent;
+  _retriggerEvent = false;
+  // La nouvelle note sort au rendu de ce tour: l'appui en attente devient l'appui mesuré
+  if (e) { _outputOnset_us = _pendingOnset_us; _pendingOnset_us = 0; }
+  return e;
+}
+unsigned long EngineMode1::getAndClearOutputOnset() { unsigned long t = _outputOnset_us; _outputOnset_us = 0; return t; }
 UIEffect EngineMode1::getAndClearRequestedEffect() { UIEffect e = _uiEffectRequested; _uiEffectRequested = UIEffect::NONE; return e; }
 
 void EngineMode1::setLatch(bool enabled, const bool* physicalKeyState) {
@@ -218,7 +241,7 @@ void EngineMode1::updateNotePriority() {
     }
     _gateOpen = false;
     _targetAuxVoltage = 0.0f;
-    _targetPitchVoltage = _lastActivePitchVoltage;
+    _targetPitchCode = _lastActivePitchCode;
     return;
   }
   Note activeNote = _noteStack[_noteStackPointer];
@@ -235,29 +258,26 @@ void EngineMode1::updateNotePriority() {
   #endif
   lastActivePitch = activeNote.pitch;
 
-  _targetPitchVoltage = midiNoteToVoltage(activeNote.pitch);
-  _lastActivePitchVoltage = _targetPitchVoltage;
+  _targetPitchCode = midiNoteToCode(activeNote.pitch);
+  _lastActivePitchCode = _targetPitchCode;
   _targetAuxVoltage = ((float)activeNote.value / CV_OUTPUT_RESOLUTION) * DAC_OUTPUT_VOLTAGE_RANGE;
 
   #if DEBUG_LEVEL == 1
-    static float lastLoggedPitchV = -1.0f;
+    static int lastLoggedPitchCode = -1;
     static float lastLoggedAuxV = -1.0f;
     const float VOLTAGE_LOG_THRESHOLD = 0.02f;
 
-    if (_gateOpen && (abs(_targetPitchVoltage - lastLoggedPitchV) > VOLTAGE_LOG_THRESHOLD || abs(_currentAuxVoltage - lastLoggedAuxV) > VOLTAGE_LOG_THRESHOLD)) {
+    if (_gateOpen && (_targetPitchCode != lastLoggedPitchCode || abs(_currentAuxVoltage - lastLoggedAuxV) > VOLTAGE_LOG_THRESHOLD)) {
         Serial.print("[MUSICAL] : Note "); Serial.print(activeNote.pitch);
-        Serial.print(" : 1v/o: "); Serial.print(_targetPitchVoltage, 2);
-        Serial.print("V ------- AUX:"); Serial.print(_currentAuxVoltage, 2); Serial.println("V");
+        Serial.print(" : 1v/o code: "); Serial.print(_targetPitchCode);
+        Serial.print(" ------- AUX:"); Serial.print(_currentAuxVoltage, 2); Serial.println("V");
         
-        lastLoggedPitchV = _targetPitchVoltage;
+        lastLoggedPitchCode = _targetPitchCode;
         lastLoggedAuxV = _currentAuxVoltage;
     }
   #endif
 }
 
-float EngineMode1::midiNoteToVoltage(uint8_t note) const {
-  int finalNoteWithOctave = note + (_octaveOffset * 12);
-  float noteDelta = finalNoteWithOctave - PITCH_REFERENCE_MIDI_NOTE;
-  float voltageOffset = (noteDelta / 12.0f) * PITCH_STANDARD_VOLTS_PER_OCTAVE;
-  return PITCH_CV_CENTER_VOLTAGE + voltageOffset;
+uint16_t EngineMode1::midiNoteToCode(uint8_t note) const {
+  return _pitchCal->noteToCode(note + (_octaveOffset * 12));
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "HardwareConfig.h" 
 #include "KeyboardData.h"   
 #include "InputManager.h"   
+#include "PitchCalibration.h"
+#include "OnePoleSmoother.h"
 
 class EngineMode1 {
 public:
@@ -17,26 +19,29 @@ public:
   EngineMode1();
 
   // --- API Principale ---
-  void begin();
+  // La table de calibration 1V/oct doit rester valide pendant toute la durée de vie du moteur
+  void begin(const PitchCalibration& pitchCal);
   void update();
   // La signature a besoin de l'état du clavier pour la fonction Latch
-  void processInputs(const InputEvents& events, const bool* physicalKeyState);
+  void handleInput(const InputEvent& event, const bool* physicalKeyState);
 
   // Méthodes pour le scan clavier (appelées par le .ino)
-  void onNoteOn(uint8_t pitch, uint16_t value);
+  // onsetTime_us: horodatage capteur de l'appui (0 = non mesuré), restitué par getAndClearOutputOnset()
+  void onNoteOn(uint8_t pitch, uint16_t value, unsigned long onsetTime_us = 0);
   void onNoteOff(uint8_t pitch);
   void onAftertouchUpdate(uint8_t keyIndex, uint16_t pressure);
   
   // --- GETTERS (API de sortie) ---
-  float getPitchVoltage() const;
+  uint16_t getPitchCode() const;  // Code DAC corrigé de la sortie Pitch
   float getAuxVoltage() const;
   bool  getGateState() const;
   bool  getAndClearRetriggerEvent();
+  unsigned long getAndClearOutputOnset();  // Appui à l'origine du retrigger courant, 0 sinon
   int   getOctaveOffset() const;
   bool  isLatchActive() const;
   int getLivePotDisplayValue() const;
   int getAftertouchDeadzoneOffset() const;
-  float getAuxSmoothingAlpha() const;  // ADD: needed for LED display
+  float getAuxSmoothingTime() const;  // ms, pour l'affichage LED et le partage avec EngineMode2
   UIEffect getAndClearRequestedEffect();
 
 private:
@@ -44,9 +49,9 @@ private:
   void pushNote(uint8_t pitch, uint16_t value);
   void popNote(uint8_t pitch);
   void updateNotePriority();
-  float midiNoteToVoltage(uint8_t note) const;
+  uint16_t midiNoteToCode(uint8_t note) const;
   void setLatch(bool enabled, const bool* physicalKeyState);
-  void setAuxSmoothingAlpha(float alpha); // Gardée pour la combinaison
+  void setAuxSmoothingStep(int step);     // Cran encodeur 0..AUX_SMOOTHING_ENCODER_STEPS
 
   // --- État interne ---
   int _octaveOffset;
@@ -59,17 +64,22 @@ private:
   Note _noteStack[NOTE_STACK_SIZE];
   int _noteStackPointer;
 
-  float _currentPitchVoltage;
-  float _targetPitchVoltage;
+  // Pitch dans le domaine des codes DAC: le glide interpole entre deux entrées de la table
+  const PitchCalibration* _pitchCal;
+  float _currentPitchCode;
+  uint16_t _targetPitchCode;
   float _glideTime_ms;
-  float _lastActivePitchVoltage;
+  uint16_t _lastActivePitchCode;
 
   float _currentAuxVoltage;
   float _targetAuxVoltage;
-  float _auxSmoothingAlpha;
+  OnePoleSmoother _auxSmoother;
+  int _auxSmoothingStep;
 
   bool _gateOpen;
   bool _retriggerEvent;
+  unsigned long _pendingOnset_us;
+  unsigned long _outputOnset_us;
 
   unsigned long _lastUpdateTime_micros;
 };
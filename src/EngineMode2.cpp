@@ -16,10 +16,17 @@ EngineMode2::EngineMode2() {
   _alphaOctave = -2;
   _bounceState = false;
 
-  _lastStepTime = 0;
-  _lastGateOffTime = 0;
   _bpm = 120;
-  _gateIsOn = false;
+  updateStepPeriod();
+  restartStepGrid(0);
+  _clockOutTicks = 0;
+  
+  _clockSync = nullptr;
+  _clockSlaved = false;
+  _syncRunning = false;
+  _syncStartCount = 0;
+  _syncStep = 0;
+  _syncStepPeriod_us = 0;
   
   _shuffleTemplate = 0;        // Start with template 1
   _shuffleDepth = 0.0f;        // No shuffle by default
@@ -27,18 +34,22 @@ EngineMode2::EngineMode2() {
   
   _patternEncoderAccum = 0;    // Initialize pattern encoder accumulator
   
-  _currentPitchVoltage = PITCH_CV_CENTER_VOLTAGE;
-  _targetPitchVoltage = PITCH_CV_CENTER_VOLTAGE;
+  _pitchCal = nullptr;
+  _currentPitchCode = 0;
+  _targetPitchCode = 0;
   _currentAuxVoltage = 0.0f;
   _targetAuxVoltage = 0.0f;
-  _auxSmoothingAlpha = AUX_VOLTAGE_SMOOTHING_ALPHA_DEFAULT;
+  _auxSmoother.setTimeConstant(AUX_SMOOTHING_TIME_DEFAULT_MS);
+  _lastUpdateTime_micros = 0;
   _gateOpen = false;
   _retriggerEvent = false;
+  _pendingOnset_us = 0;
+  _outputOnset_us = 0;
   
   _octaveOffset = 0;
   _latchEnabled = false;
   // Calculate initial bargraph display value from default BPM
-  _livePotDisplayValue = map(_bpm, 5, 900, 0, 100);  // Should be ~13 for BPM=120
+  _livePotDisplayValue = map(_bpm, ARP_BPM_MIN, ARP_BPM_MAX, 0, 100);  // Should be ~13 for BPM=120
   _uiEffectRequested = UIEffect::NONE;
   _shiftModeActive = false;
   
@@ -49,13 +60,41 @@ EngineMode2::EngineMode2() {
   }
 }
 
-void EngineMode2::begin() {
-  _lastStepTime = millis();
+void EngineMode2::begin(const PitchCalibration& pitchCal) {
+  _pitchCal = &pitchCal;
+  _targetPitchCode = _pitchCal->noteToCode(PITCH_REFERENCE_MIDI_NOTE);
+  _currentPitchCode = _targetPitchCode;
+  _lastUpdateTime_micros = micros();
+  restartStepGrid(_lastUpdateTime_micros);
   randomSeed(analogRead(0));  // Seed random for RANDOM pattern
 }
 
 void EngineMode2::update() {
-  unsigned long now = millis();
+  unsigned long nowMicros = micros();
+  uint32_t deltaTime_micros = nowMicros - _lastUpdateTime_micros;  // Unsigned: wrap-safe
+  _lastUpdateTime_micros = nowMicros;
+  
+  // Tempo source: the external MIDI clock while it is locked, the internal grid otherwise
+  bool slaved = (_clockSync != nullptr) && _clockSync->isLocked(nowMicros);
+  if (slaved != _clockSlaved) {
+    _clockSlaved = slaved;
+    if (slaved) {
+      // Join a running transport on its next beat, like a Continue
+      _syncStartCount = _clockSync->getStartCount();
+      _syncRunning = false;
+    } else {
+      // Clock lost: keep playing on the internal tempo from here
+      restartStepGrid(nowMicros);
+    }
+    #if DEBUG_LEVEL >= 1
+    Serial.println(slaved ? "Arp: external MIDI clock" : "Arp: internal clock");
+    #endif
+  }
+  if (_clockSlaved) {
+    followClock();
+  } else {
+    updateClockOut(nowMicros);
+  }
   
   // If only one note or no notes, behave like monophonic mode
   if (_arpCount <= 1) {
@@ -65,80 +104,58 @@ void EngineMode2::update() {
     } else {
       // Single note: maintain gate state (don't force always on)
       // Gate was set by onNoteOn and will stay on until removed
-      _targetPitchVoltage = midiNoteToVoltage(_arpNotes[0]);
+      _targetPitchCode = midiNoteToCode(_arpNotes[0]);
       _targetAuxVoltage = ((float)_arpPressures[0] / CV_OUTPUT_RESOLUTION) * DAC_OUTPUT_VOLTAGE_RANGE;
     }
-    _currentPitchVoltage = _targetPitchVoltage;
+    _currentPitchCode = _targetPitchCode;
     // Apply smoothing even for single note
-    _currentAuxVoltage = (1.0f - _auxSmoothingAlpha) * _currentAuxVoltage + _auxSmoothingAlpha * _targetAuxVoltage;
+    _currentAuxVoltage = _auxSmoother.process(_targetAuxVoltage, deltaTime_micros);
     return;
   }
   
-  // Arpeggiator mode for multiple notes
-  float stepTime_ms = 60000.0f / _bpm;
-  
-  // Calculate shuffle offset for NEXT step (before checking timing)
-  float shuffleOffset = 0.0f;
-  if (_shuffleDepth > 0.0f && 
-      _shuffleTemplate < SHUFFLE_TEMPLATE_COUNT &&
-      _shuffleStepCounter < SHUFFLE_STEPS_PER_CYCLE) {
-    int8_t templateOffset = SHUFFLE_TEMPLATES[_shuffleTemplate][_shuffleStepCounter];
-    shuffleOffset = (templateOffset * _shuffleDepth * stepTime_ms) / 100.0f;
-    
+  // Arpeggiator mode for multiple notes: a step is due at its grid time plus its shuffle
+  // offset. The grid only moves by whole step periods, so late updates add jitter, never drift.
+  uint32_t grid_us;
+  int32_t shuffle_us = shuffleOffset_us();
+  if (nextStepGrid(grid_us) && (int32_t)(nowMicros - (grid_us + (uint32_t)shuffle_us)) >= 0) {
     #if DEBUG_LEVEL >= 2
     Serial.print("Step ");
     Serial.print(_shuffleStepCounter);
-    Serial.print(": offset=");
-    Serial.print(templateOffset);
-    Serial.print("% shuffle=");
-    Serial.print(shuffleOffset);
-    Serial.println("ms");
+    Serial.print(": shuffle=");
+    Serial.print(shuffle_us);
+    Serial.print("us late=");
+    Serial.print((int32_t)(nowMicros - grid_us) - shuffle_us);
+    Serial.println("us");
     #endif
-  }
-  
-  // Check if it's time for next step (with shuffle applied to wait time)
-  float effectiveWaitTime = stepTime_ms + shuffleOffset;
-  
-  // Safety: clamp effective wait time to reasonable bounds
-  if (effectiveWaitTime < 50.0f) effectiveWaitTime = 50.0f;  // Minimum 50ms
-  if (effectiveWaitTime > stepTime_ms * 2.0f) effectiveWaitTime = stepTime_ms * 2.0f;
-  
-  if (now - _lastStepTime >= (unsigned long)effectiveWaitTime) {
-    // Advance timing to maintain grid (use base stepTime, not shuffled)
-    _lastStepTime += (unsigned long)stepTime_ms;
-    
-    // Handle overflow or large drift case
-    if (_lastStepTime < now - stepTime_ms * 2) {
-      _lastStepTime = now;  // Resync if too far behind
-    }
     
+    advanceStepGrid();
     stepToNext();
     _retriggerEvent = true;
-    _gateIsOn = true;
-    
-    // Fixed gate length at 50% for shuffle mode
-    _lastGateOffTime = _lastStepTime + (stepTime_ms * 0.5f);
     
     // Increment shuffle step counter (wraps at 8)
     _shuffleStepCounter = (_shuffleStepCounter + 1) % SHUFFLE_STEPS_PER_CYCLE;
+    
+    // Stalled for a whole step or more: drop the missed steps instead of playing them in a burst,
+    // the grid (and the groove position) stays in phase
+    while (nextStepGrid(grid_us) && (int32_t)(nowMicros - grid_us) >= 0) {
+      advanceStepGrid();
+      _shuffleStepCounter = (_shuffleStepCounter + 1) % SHUFFLE_STEPS_PER_CYCLE;
+    }
   }
   
-  // Update gate state based on gate length
-  updateGateState(now);
-  
   // Update pressure from current arpeggiating note
   updateCurrentNotePressure();
   
   // Apply smoothing to AUX voltage (like Engine1)
-  _currentAuxVoltage = (1.0f - _auxSmoothingAlpha) * _currentAuxVoltage + _auxSmoothingAlpha * _targetAuxVoltage;
+  _currentAuxVoltage = _auxSmoother.process(_targetAuxVoltage, deltaTime_micros);
   
   // Smooth pitch transition (instant for arpeggiator)
-  _currentPitchVoltage = _targetPitchVoltage;
+  _currentPitchCode = _targetPitchCode;
 }
 
-void EngineMode2::processInputs(const InputEvents& events, const bool* physicalKeyState) {
+void EngineMode2::handleInput(const InputEvent& event, const bool* physicalKeyState) {
   // Hold button - toggle latch
-  if (events.hold_wasPressedShort) {
+  if (event.type == InputEventType::HOLD_SHORT) {
     bool wasLatched = _latchEnabled;
     setLatch(!_latchEnabled, physicalKeyState);
     // Only reset pattern when turning off latch (switching from latch to normal)
@@ -148,22 +165,23 @@ void EngineMode2::processInputs(const InputEvents& events, const bool* physicalK
     _uiEffectRequested = UIEffect::VALIDATE;
   }
   
-  // Shift mode detection
-  bool shiftPlus = events.octPlus_isLongPressed;
-  bool shiftMinus = events.octMinus_isLongPressed;
+  // Shift state as it was when the event was recorded
+  bool shiftPlus = event.modifiers & INPUT_MOD_SHIFT_PLUS;
+  bool shiftMinus = event.modifiers & INPUT_MOD_SHIFT_MINUS;
+  bool encoderTurned = (event.type == InputEventType::ENCODER);
 
   // Octave transpose
-  if (events.octPlus_wasReleasedAsShort) {
+  if (event.type == InputEventType::OCT_PLUS_SHORT) {
     if (_octaveOffset < MAX_OCTAVE) _octaveOffset++;
   }
-  if (events.octMinus_wasReleasedAsShort) {
+  if (event.type == InputEventType::OCT_MINUS_SHORT) {
     if (_octaveOffset > MIN_OCTAVE) _octaveOffset--;
   }
   
   // Encoder controls
-  if (shiftPlus && events.live_encoderTurned) {
+  if (shiftPlus && encoderTurned) {
     // Pattern selection with reduced sensitivity
-    _patternEncoderAccum += events.live_encoderDelta;
+    _patternEncoderAccum += event.value;
     
     // 5 clicks = 1 pattern change (one turn ≈ 24 clicks = ~5 patterns)
     const int CLICKS_PER_PATTERN = 5;
@@ -195,9 +213,9 @@ void EngineMode2::processInputs(const InputEvents& events, const bool* physicalK
       _arpIndex = _arpCount - 1;
     }
   }
-  else if (shiftMinus && events.live_encoderTurned) {
+  else if (shiftMinus && encoderTurned) {
     // Shuffle control: template selection + depth
-    float newDepth = _shuffleDepth + (events.live_encoderDelta * SHUFFLE_DEPTH_STEP);
+    float newDepth = _shuffleDepth + (event.value * SHUFFLE_DEPTH_STEP);
     
     #if DEBUG_LEVEL >= 1
     Serial.print("Shuffle: template=");
@@ -240,24 +258,23 @@ void EngineMode2::processInputs(const InputEvents& events, const bool* physicalK
       _shuffleDepth = newDepth;
     }
   }
-  else if (events.live_encoderTurned) {
+  else if (encoderTurned) {
     // BPM control with velocity-based smooth acceleration
     float stepSize = calculateEncoderStep(
-      events.live_encoderVelocity,
+      event.velocity,
       BPM_STEP_MIN,
       BPM_STEP_MAX,
       BPM_ACCEL_CURVE
     );
     
-    _bpm = constrain(
-      _bpm + (int)(events.live_encoderDelta * stepSize),
-      5, 900
-    );
-    _livePotDisplayValue = map(_bpm, 5, 900, 0, 100);
+    setTempo(constrain(
+      _bpm + (int)(event.value * stepSize),
+      ARP_BPM_MIN, ARP_BPM_MAX
+    ));
   }
 }
 
-void EngineMode2::onNoteOn(uint8_t pitch, uint16_t value) {
+void EngineMode2::onNoteOn(uint8_t pitch, uint16_t value, unsigned long onsetTime_us) {
   // In latch mode: Check for double-tap to remove note
   if (_latchEnabled) {
     for (uint8_t i = 0; i < _arpCount; i++) {
@@ -289,6 +306,9 @@ void EngineMode2::onNoteOn(uint8_t pitch, uint16_t value) {
     }
   }
   
+  // The new note is heard at the next retrigger (immediately if it is the first one, else at the next step)
+  if (_pendingOnset_us == 0) _pendingOnset_us = onsetTime_us;
+
   // Add new note if space available
   if (_arpCount < MAX_ARP_NOTES) {
     // Remember the note that was playing before sorting
@@ -373,14 +393,19 @@ void EngineMode2::onAftertouchUpdate(uint8_t keyIndex, uint16_t pressure) {
   }
 }
 
-float EngineMode2::getPitchVoltage() const {
-  return _currentPitchVoltage;
+uint16_t EngineMode2::getPitchCode() const {
+  return _currentPitchCode;
 }
 
 float EngineMode2::getAuxVoltage() const {
   return _currentAuxVoltage;
 }
 
+uint32_t EngineMode2::getGateLength_us() const {
+  // Fixed gate length at 50% of the step for shuffle mode; the falling edge is timed by PulseOutputs
+  return (_arpCount > 1) ? stepPeriod_us() / 2 : 0;
+}
+
 bool EngineMode2::getGateState() const {
   return _gateOpen;
 }
@@ -388,9 +413,19 @@ bool EngineMode2::getGateState() const {
 bool EngineMode2::getAndClearRetriggerEvent() {
   bool event = _retriggerEvent;
   _retriggerEvent = false;
+  if (event) {
+    _outputOnset_us = _pendingOnset_us;
+    _pendingOnset_us = 0;
+  }
   return event;
 }
 
+unsigned long EngineMode2::getAndClearOutputOnset() {
+  unsigned long onset = _outputOnset_us;
+  _outputOnset_us = 0;
+  return onset;
+}
+
 int EngineMode2::getOctaveOffset() const {
   return _octaveOffset;
 }
@@ -437,10 +472,95 @@ void EngineMode2::resetPattern() {
   _waveDirection = true;
   _alphaOctave = -2;
   _bounceState = false;
-  _lastStepTime = millis();
+  restartStepGrid(micros());
   _shuffleStepCounter = 0;  // Reset shuffle counter
 }
 
+void EngineMode2::updateStepPeriod() {
+  _stepGrid.setPeriod(60000000UL, _bpm);
+  _clockOutGrid.setPeriod(60000000UL / MIDI_CLOCKS_PER_BEAT, _bpm);
+}
+
+void EngineMode2::restartStepGrid(uint32_t now_us) {
+  // The step played now is on the grid; the next one is a full period later.
+  // The clock out restarts with it so a slaved DAW stays on the arp's beats.
+  _stepGrid.restart(now_us);
+  _clockOutGrid.restart(now_us);
+  _clockOutTicks = 1;
+}
+
+void EngineMode2::followClock() {
+  bool running = _clockSync->isRunning();
+  if (_clockSync->getStartCount() != _syncStartCount) {
+    // Start: the pattern restarts on beat 0
+    _syncStartCount = _clockSync->getStartCount();
+    resetPattern();
+    _syncStep = 0;
+  } else if (running && !_syncRunning) {
+    // Continue: resume on the next whole beat of the song position
+    _syncStep = (_clockSync->getNextTickPosition() + MIDI_CLOCKS_PER_BEAT - 1) / MIDI_CLOCKS_PER_BEAT;
+  }
+  _syncRunning = running;
+  _syncStepPeriod_us = (uint32_t)(_clockSync->getTickPeriod_us() * MIDI_CLOCKS_PER_BEAT);
+  
+  // Groove position follows the song position, not the first key press
+  _shuffleStepCounter = _syncStep % SHUFFLE_STEPS_PER_CYCLE;
+}
+
+void EngineMode2::updateClockOut(uint32_t now_us) {
+  while (_clockOutGrid.isDue(now_us)) {
+    _clockOutGrid.advance();
+    _clockOutTicks++;
+    if (_clockOutTicks > MIDI_CLOCKS_PER_BEAT) {
+      // Not updated for over a beat (other mode active): restart instead of sending a burst
+      _clockOutGrid.restart(now_us);
+      _clockOutTicks = 1;
+      break;
+    }
+  }
+}
+
+bool EngineMode2::nextStepGrid(uint32_t& grid_us) const {
+  if (!_clockSlaved) {
+    grid_us = _stepGrid.next();
+    return true;
+  }
+  // Slave: steps only while the transport runs, on the smoothed time of the beat's first clock
+  if (!_syncRunning) return false;
+  grid_us = _clockSync->predictTick_us(_syncStep * MIDI_CLOCKS_PER_BEAT);
+  return true;
+}
+
+void EngineMode2::advanceStepGrid() {
+  if (_clockSlaved) {
+    _syncStep++;
+  } else {
+    _stepGrid.advance();
+  }
+}
+
+uint32_t EngineMode2::stepPeriod_us() const {
+  return _clockSlaved ? _syncStepPeriod_us : _stepGrid.period();
+}
+
+int32_t EngineMode2::shuffleOffset_us() const {
+  if (_shuffleDepth <= 0.0f ||
+      _shuffleTemplate >= SHUFFLE_TEMPLATE_COUNT ||
+      _shuffleStepCounter >= SHUFFLE_STEPS_PER_CYCLE) {
+    return 0;
+  }
+  // Phase shift inside the step, relative to its own grid time (never carried to the next step)
+  int8_t templateOffset = SHUFFLE_TEMPLATES[_shuffleTemplate][_shuffleStepCounter];
+  uint32_t period_us = stepPeriod_us();
+  int32_t offset_us = (int32_t)(templateOffset * _shuffleDepth * period_us / 100.0f);
+  
+  // Safety: keep each step inside its own period so steps stay in order
+  int32_t maxOffset_us = (int32_t)period_us - 1;
+  if (offset_us > maxOffset_us) offset_us = maxOffset_us;
+  if (offset_us < -maxOffset_us / 2) offset_us = -maxOffset_us / 2;
+  return offset_us;
+}
+
 void EngineMode2::stepToNext() {
   if (_arpCount == 0) return;
   
@@ -745,7 +865,7 @@ void EngineMode2::updatePitchFromCurrentNote() {
       default:
         break;
     }
-    _targetPitchVoltage = midiNoteToVoltageWithOctave(_arpNotes[_arpIndex], octaveShift);
+    _targetPitchCode = midiNoteToCodeWithOctave(_arpNotes[_arpIndex], octaveShift);
   }
 }
 
@@ -763,23 +883,35 @@ void EngineMode2::updateCurrentNotePressure() {
   }
 }
 
-void EngineMode2::setSharedAftertouchParams(float smoothingAlpha) {
-  _auxSmoothingAlpha = smoothingAlpha;
+void EngineMode2::setSharedAftertouchParams(float smoothingTime_ms) {
+  _auxSmoother.setTimeConstant(smoothingTime_ms);
 }
 
-void EngineMode2::updateGateState(unsigned long now) {
-  if (_arpCount == 0) {
-    _gateOpen = false;
-    _gateIsOn = false;
-    return;
-  }
-  
-  // Handle gate length timing
-  if (_gateIsOn && now >= _lastGateOffTime) {
-    _gateIsOn = false;
-  }
-  
-  _gateOpen = _gateIsOn;
+void EngineMode2::setTempo(uint16_t bpm) {
+  bpm = constrain(bpm, ARP_BPM_MIN, ARP_BPM_MAX);
+  _livePotDisplayValue = map(bpm, ARP_BPM_MIN, ARP_BPM_MAX, 0, 100);
+  if (bpm == _bpm) return;
+  _bpm = bpm;
+  updateStepPeriod();
+}
+
+uint16_t EngineMode2::getTempo() const {
+  return _bpm;
+}
+
+void EngineMode2::setClockSync(const MidiClockSync* clockSync) {
+  _clockSync = clockSync;
+}
+
+bool EngineMode2::isClockSlaved() const {
+  return _clockSlaved;
+}
+
+uint8_t EngineMode2::getAndClearClockOutTicks() {
+  // Never echo a clock back while following one
+  uint8_t ticks = _clockSlaved ? 0 : _clockOutTicks;
+  _clockOutTicks = 0;
+  return ticks;
 }
 
 void EngineMode2::sortArpNotes() {
@@ -842,18 +974,12 @@ void EngineMode2::setLatch(bool enabled, const bool* physicalKeyState) {
   }
 }
 
-float EngineMode2::midiNoteToVoltage(uint8_t note) const {
-  int finalNoteWithOctave = note + (_octaveOffset * 12);
-  float noteDelta = finalNoteWithOctave - PITCH_REFERENCE_MIDI_NOTE;
-  float voltageOffset = (noteDelta / 12.0f) * PITCH_STANDARD_VOLTS_PER_OCTAVE;
-  return PITCH_CV_CENTER_VOLTAGE + voltageOffset;
+uint16_t EngineMode2::midiNoteToCode(uint8_t note) const {
+  return _pitchCal->noteToCode(note + (_octaveOffset * 12));
 }
 
-float EngineMode2::midiNoteToVoltageWithOctave(uint8_t note, int additionalOctave) const {
-  int finalNoteWithOctave = note + ((_octaveOffset + additionalOctave) * 12);
-  float noteDelta = finalNoteWithOctave - PITCH_REFERENCE_MIDI_NOTE;
-  float voltageOffset = (noteDelta / 12.0f) * PITCH_STANDARD_VOLTS_PER_OCTAVE;
-  return PITCH_CV_CENTER_VOLTAGE + voltageOffset;
+uint16_t EngineMode2::midiNoteToCodeWithOctave(uint8_t note, int additionalOctave) const {
+  return _pitchCal->noteToCode(note + ((_octaveOffset + additionalOctave) * 12));
 }
 
 void EngineMode2::removeNote(uint8_t pitch) {
@@ -886,6 +1012,7 @@ void EngineMode2::removeNote(uint8_t pitch) {
     } else if (_arpCount == 0) {
       _arpIndex = 0;
       _gateOpen = false;
+      _pendingOnset_us = 0;  // Released before being heard: nothing to measure
     }
   }
 }
\ No newline at end of file
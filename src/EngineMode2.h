@@ -5,6 +5,10 @@
 #include "HardwareConfig.h"
 #include "KeyboardData.h"
 #include "InputManager.h"
+#include "PitchCalibration.h"
+#include "OnePoleSmoother.h"
+#include "TempoGrid.h"
+#include "MidiClockSync.h"
 
 // Arpeggiator patterns - easy to extend
 enum class ArpPattern {
@@ -31,19 +35,23 @@ public:
   EngineMode2();
 
   // --- Main API ---
-  void begin();
+  // The 1V/oct calibration table must outlive the engine
+  void begin(const PitchCalibration& pitchCal);
   void update();
-  void processInputs(const InputEvents& events, const bool* physicalKeyState);
+  void handleInput(const InputEvent& event, const bool* physicalKeyState);
 
-  void onNoteOn(uint8_t pitch, uint16_t value);
+  void onNoteOn(uint8_t pitch, uint16_t value, unsigned long onsetTime_us = 0);
   void onNoteOff(uint8_t pitch);
   void onAftertouchUpdate(uint8_t keyIndex, uint16_t pressure);
 
   // --- Getters ---
-  float getPitchVoltage() const;
+  uint16_t getPitchCode() const;  // Calibrated DAC code for the Pitch output
   float getAuxVoltage() const;
   bool  getGateState() const;
+  // Arp running: gate pulse length opened on each retrigger (0 = gate held at getGateState())
+  uint32_t getGateLength_us() const;
   bool  getAndClearRetriggerEvent();
+  unsigned long getAndClearOutputOnset();  // Appui entendu au retrigger courant, 0 sinon
   int   getOctaveOffset() const;
   bool  isLatchActive() const;
   int   getLivePotDisplayValue() const;
@@ -56,7 +64,17 @@ public:
   float getShuffleDepth() const;
   
   // Setter for shared aftertouch parameters from Engine1
-  void setSharedAftertouchParams(float smoothingAlpha);
+  void setSharedAftertouchParams(float smoothingTime_ms);
+
+  // Arp tempo, clamped to ARP_BPM_MIN..ARP_BPM_MAX; takes effect from the next step
+  void setTempo(uint16_t bpm);
+  uint16_t getTempo() const;
+
+  // External clock to follow while it is locked (nullptr = always internal); must outlive the engine
+  void setClockSync(const MidiClockSync* clockSync);
+  bool isClockSlaved() const;
+  // Master only: MIDI clocks (24 ppqn of the internal tempo) due since the last call
+  uint8_t getAndClearClockOutTicks();
 
 private:
   // Arpeggiator state
@@ -80,11 +98,19 @@ private:
   int8_t _alphaOctave;                     // For OCTAVE_ALPHA, from -2 to +2
   bool _bounceState;                       // For OCTAVE_BOUNCE, false=low, true=high
   
-  // Timing
-  unsigned long _lastStepTime;
-  unsigned long _lastGateOffTime;
+  // Timing: internal step grid (60e6 / bpm us) and MIDI clock out grid (24 per step)
+  TempoGrid _stepGrid;                     // Next unshuffled step time
+  TempoGrid _clockOutGrid;
+  uint8_t _clockOutTicks;
   uint16_t _bpm;
-  bool _gateIsOn;
+  
+  // External clock sync (slave)
+  const MidiClockSync* _clockSync;
+  bool _clockSlaved;
+  bool _syncRunning;                       // Transport state seen at the last update
+  uint16_t _syncStartCount;
+  uint32_t _syncStep;                      // Beat index (since Start) of the next step
+  uint32_t _syncStepPeriod_us;             // Smoothed external beat period
   
   // Shuffle/Groove parameters (replaces gate length)
   uint8_t _shuffleTemplate;     // 0-4 (which groove template)
@@ -95,13 +121,17 @@ private:
   int _patternEncoderAccum;     // Accumulates encoder clicks for pattern selection
   
   // Output values
-  float _currentPitchVoltage;
-  float _targetPitchVoltage;
+  const PitchCalibration* _pitchCal;
+  uint16_t _currentPitchCode;
+  uint16_t _targetPitchCode;
   float _currentAuxVoltage;
   float _targetAuxVoltage;                 // Target for smoothing
-  float _auxSmoothingAlpha;                // Shared from Engine1
+  OnePoleSmoother _auxSmoother;            // Time constant shared from Engine1
+  unsigned long _lastUpdateTime_micros;    // Elapsed time for the smoother
   bool _gateOpen;
   bool _retriggerEvent;
+  unsigned long _pendingOnset_us;          // Appui ajouté au motif, pas encore joué
+  unsigned long _outputOnset_us;
   
   // Control state
   int _octaveOffset;
@@ -112,6 +142,14 @@ private:
   
   // Helper methods
   void resetPattern();
+  void updateStepPeriod();
+  void restartStepGrid(uint32_t now_us);
+  void followClock();
+  void updateClockOut(uint32_t now_us);
+  bool nextStepGrid(uint32_t& grid_us) const;
+  void advanceStepGrid();
+  uint32_t stepPeriod_us() const;
+  int32_t shuffleOffset_us() const;
   void stepToNext();
   void stepPatternUp();
   void stepPatternDown();
@@ -130,11 +168,10 @@ private:
   void stepPatternOctaveBounce();
   void updatePitchFromCurrentNote();
   void updateCurrentNotePressure();
-  void updateGateState(unsigned long now);
   void sortArpNotes();
   void setLatch(bool enabled, const bool* physicalKeyState);
-  float midiNoteToVoltage(uint8_t note) const;
-  float midiNoteToVoltageWithOctave(uint8_t note, int octaveOffset) const;
+  uint16_t midiNoteToCode(uint8_t note) const;
+  uint16_t midiNoteToCodeWithOctave(uint8_t note, int octaveOffset) const;
   void removeNote(uint8_t pitch);
 };
 
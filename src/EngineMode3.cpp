@@ -1,4 +1,344 @@
 #include "EngineMode3.h"
+#include <Arduino.h>
+#include <math.h>
 
-// Ce fichier est intentionnellement vide.
-// L'implémentation du placeholder se trouve entièrement dans EngineMode3.h
\ No newline at end of file
+// Index de la source aux sur l'encodeur: pression, vélocité, puis CC 0..119 (120+ = Channel Mode)
+static const int AUX_SOURCE_STEPS = 2 + 120;
+
+EngineMode3::EngineMode3() {
+  _stackCount = 0;
+  _activeIndex = -1;
+  _activePitch = 0;
+  _priority = NotePriority::LAST;
+  _auxSource = AuxSource::CHANNEL_PRESSURE;
+  _auxControlNumber = MIDI_AUX_CC_DEFAULT;
+  _bendRange = PITCH_BEND_RANGE_DEFAULT;
+  _legato = false;
+  _octaveOffset = 0;
+  _latchEnabled = false;
+
+  _pitchCal = nullptr;
+  _pitchCode = 0;
+  _bend = 0;
+  _channelPressure = 0;
+  _controlValue = 0;
+  _targetAuxVoltage = 0.0f;
+  _currentAuxVoltage = 0.0f;
+  _auxSmoother.setTimeConstant(AUX_SMOOTHING_TIME_DEFAULT_MS);
+  _lastUpdateTime_micros = 0;
+  _gateOpen = false;
+  _retriggerEvent = false;
+  _pendingOnset_us = 0;
+  _outputOnset_us = 0;
+
+  _livePotDisplayValue = _bendRange * 100 / PITCH_BEND_RANGE_MAX;
+  _uiEffectRequested = UIEffect::NONE;
+}
+
+void EngineMode3::begin(const PitchCalibration& pitchCal) {
+  _pitchCal = &pitchCal;
+  // Au repos: PITCH_CV_CENTER_VOLTAGE, comme avant la première note
+  _activePitch = PITCH_REFERENCE_MIDI_NOTE;
+  updatePitchCode();
+  _lastUpdateTime_micros = micros();
+}
+
+void EngineMode3::update() {
+  unsigned long now = micros();
+  uint32_t deltaTime_micros = now - _lastUpdateTime_micros;  // Non signé: insensible au rebouclage
+  _lastUpdateTime_micros = now;
+
+  // Budget par tick: une rafale se répartit sur les ticks suivants
+  Event event;
+  for (uint8_t n = 0; n < MIDI_EVENTS_PER_UPDATE && _events.pop(event); n++) {
+    applyEvent(event);
+  }
+
+  _currentAuxVoltage = _auxSmoother.process(_targetAuxVoltage, deltaTime_micros);
+}
+
+void EngineMode3::handleInput(const InputEvent& event, const bool* physicalKeyState) {
+  (void)physicalKeyState;  // Le latch porte sur les notes MIDI, pas sur le clavier
+
+  switch (event.type) {
+    // --- Boutons ---
+    case InputEventType::HOLD_SHORT:
+      setLatch(!_latchEnabled);
+      _uiEffectRequested = UIEffect::VALIDATE;
+      break;
+    case InputEventType::HOLD_LONG:
+      _legato = !_legato;
+      _uiEffectRequested = UIEffect::VALIDATE;
+      break;
+    case InputEventType::OCT_PLUS_SHORT:
+      if (_octaveOffset < MAX_OCTAVE) _octaveOffset++;
+      updatePitchCode();
+      break;
+    case InputEventType::OCT_MINUS_SHORT:
+      if (_octaveOffset > MIN_OCTAVE) _octaveOffset--;
+      updatePitchCode();
+      break;
+
+    // --- Encodeur (shift lu dans les modificateurs de l'événement) ---
+    case InputEventType::ENCODER:
+      if (event.modifiers & INPUT_MOD_SHIFT_PLUS) {
+        stepAuxSource(event.value);
+        _uiEffectRequested = UIEffect::VALIDATE;
+      } else if (event.modifiers & INPUT_MOD_SHIFT_MINUS) {
+        int priority = constrain((int)_priority + event.value, 0, (int)NotePriority::COUNT - 1);
+        setNotePriority((NotePriority)priority);
+        _livePotDisplayValue = priority * 100 / ((int)NotePriority::COUNT - 1);
+      } else {
+        setPitchBendRange(constrain((int)_bendRange + event.value, 0, (int)PITCH_BEND_RANGE_MAX));
+        _livePotDisplayValue = _bendRange * 100 / PITCH_BEND_RANGE_MAX;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+// --- Réception: file uniquement, appelée depuis la lecture du port ---
+
+void EngineMode3::onMidiNoteOn(uint8_t pitch, uint8_t velocity) {
+  queueEvent(velocity ? EventType::NOTE_ON : EventType::NOTE_OFF, pitch, velocity);
+}
+
+void EngineMode3::onMidiNoteOff(uint8_t pitch) {
+  queueEvent(EventType::NOTE_OFF, pitch, 0);
+}
+
+void EngineMode3::onMidiPitchBend(int bend) {
+  unsigned raw = (unsigned)(constrain(bend, -8192, 8191) + 8192);
+  queueEvent(EventType::PITCH_BEND, raw & 0x7F, (raw >> 7) & 0x7F);
+}
+
+void EngineMode3::onMidiControlChange(uint8_t number, uint8_t value) {
+  queueEvent(EventType::CONTROL_CHANGE, number, value);
+}
+
+void EngineMode3::onMidiChannelPressure(uint8_t pressure) {
+  queueEvent(EventType::CHANNEL_PRESSURE, pressure, 0);
+}
+
+void EngineMode3::queueEvent(EventType type, uint8_t data1, uint8_t data2) {
+  Event event = { type, data1, data2, (uint32_t)micros() };
+  if (!_events.push(event)) {
+    #if DEBUG_LEVEL >= 1
+    Serial.println("MIDI: file pleine, message perdu");
+    #endif
+  }
+}
+
+void EngineMode3::reset() {
+  _events.clear();
+  _stackCount = 0;
+  _bend = 0;
+  _channelPressure = 0;
+  _controlValue = 0;
+  _gateOpen = false;
+  _retriggerEvent = false;
+  _pendingOnset_us = 0;
+  updateActiveNote(0);
+}
+
+// --- Application des messages ---
+
+void EngineMode3::applyEvent(const Event& event) {
+  switch (event.type) {
+    case EventType::NOTE_ON:
+      noteOn(event.data1, event.data2, event.time_us);
+      break;
+    case EventType::NOTE_OFF:
+      noteOff(event.data1);
+      break;
+    case EventType::PITCH_BEND:
+      _bend = (int)(event.data1 | (event.data2 << 7)) - 8192;
+      updatePitchCode();
+      break;
+    case EventType::CONTROL_CHANGE:
+      if (_auxSource == AuxSource::CONTROL_CHANGE && event.data1 == _auxControlNumber) {
+        _controlValue = event.data2;
+        updateAuxTarget();
+      }
+      break;
+    case EventType::CHANNEL_PRESSURE:
+      _channelPressure = event.data1;
+      updateAuxTarget();
+      break;
+  }
+}
+
+void EngineMode3::noteOn(uint8_t pitch, uint8_t velocity, uint32_t time_us) {
+  removeNote(pitch);
+  if (_stackCount >= NOTE_STACK_SIZE) {
+    // Pile pleine: la note la plus ancienne cède sa place
+    for (int i = 0; i < _stackCount - 1; i++) _stack[i] = _stack[i + 1];
+    _stackCount--;
+  }
+  _stack[_stackCount++] = { pitch, velocity, false };
+  updateActiveNote(time_us);
+}
+
+void EngineMode3::noteOff(uint8_t pitch) {
+  if (_latchEnabled) {
+    for (int i = 0; i < _stackCount; i++) {
+      if (_stack[i].pitch == pitch) _stack[i].released = true;
+    }
+    return;
+  }
+  removeNote(pitch);
+  updateActiveNote(0);
+}
+
+void EngineMode3::removeNote(uint8_t pitch) {
+  for (int i = 0; i < _stackCount; i++) {
+    if (_stack[i].pitch == pitch) {
+      for (int j = i; j < _stackCount - 1; j++) _stack[j] = _stack[j + 1];
+      _stackCount--;
+      return;
+    }
+  }
+}
+
+int EngineMode3::selectActiveNote() const {
+  if (_stackCount == 0) return -1;
+  int selected = _stackCount - 1;  // LAST: la plus récente
+  if (_priority == NotePriority::LOWEST) {
+    for (int i = 0; i < _stackCount; i++) {
+      if (_stack[i].pitch < _stack[selected].pitch) selected = i;
+    }
+  } else if (_priority == NotePriority::HIGHEST) {
+    for (int i = 0; i < _stackCount; i++) {
+      if (_stack[i].pitch > _stack[selected].pitch) selected = i;
+    }
+  }
+  return selected;
+}
+
+void EngineMode3::updateActiveNote(uint32_t time_us) {
+  _activeIndex = selectActiveNote();
+  if (_activeIndex < 0) {
+    // Plus de note: la gate tombe, la CV de pitch reste sur la dernière note (release).
+    // La pression de canal appartient à la phrase jouée: la suivante repart de 0
+    _gateOpen = false;
+    _channelPressure = 0;
+    updateAuxTarget();
+    return;
+  }
+
+  uint8_t pitch = _stack[_activeIndex].pitch;
+  if (!_gateOpen) {
+    _gateOpen = true;
+    _retriggerEvent = true;
+  } else if (pitch != _activePitch && !_legato) {
+    _retriggerEvent = true;
+  }
+  if (_retriggerEvent && _pendingOnset_us == 0) _pendingOnset_us = time_us;
+
+  _activePitch = pitch;
+  updatePitchCode();
+  updateAuxTarget();
+}
+
+void EngineMode3::updatePitchCode() {
+  if (_pitchCal == nullptr) return;
+  // Note + bend en demi-tons fractionnaires, interpolé entre les deux entrées de table voisines
+  float semitones = _activePitch + _octaveOffset * 12 + (_bend * (float)_bendRange) / 8192.0f;
+  float whole = floorf(semitones);
+  float frac = semitones - whole;
+  int32_t low = _pitchCal->noteToCode((int)whole);
+  int32_t high = _pitchCal->noteToCode((int)whole + 1);
+  _pitchCode = (uint16_t)(low + (int32_t)lroundf(frac * (high - low)));
+}
+
+void EngineMode3::updateAuxTarget() {
+  uint8_t value = 0;
+  switch (_auxSource) {
+    case AuxSource::CHANNEL_PRESSURE: value = _channelPressure; break;
+    case AuxSource::CONTROL_CHANGE:   value = _controlValue; break;
+    case AuxSource::VELOCITY:         value = (_activeIndex >= 0) ? _stack[_activeIndex].velocity : 0; break;
+  }
+  // Pression et vélocité suivent la note; un CC garde sa valeur entre les notes
+  if (_activeIndex < 0 && _auxSource != AuxSource::CONTROL_CHANGE) value = 0;
+  _targetAuxVoltage = (value / 127.0f) * DAC_OUTPUT_VOLTAGE_RANGE;
+}
+
+// --- Réglages ---
+
+void EngineMode3::setNotePriority(NotePriority priority) {
+  if (priority >= NotePriority::COUNT) return;
+  _priority = priority;
+  updateActiveNote(0);
+}
+
+void EngineMode3::setAuxSource(AuxSource source, uint8_t controlNumber) {
+  _auxSource = source;
+  _auxControlNumber = controlNumber & 0x7F;
+  _controlValue = 0;  // Valeur du nouveau CC inconnue jusqu'au prochain message
+  updateAuxTarget();
+}
+
+void EngineMode3::stepAuxSource(int delta) {
+  int index;
+  switch (_auxSource) {
+    case AuxSource::CHANNEL_PRESSURE: index = 0; break;
+    case AuxSource::VELOCITY:         index = 1; break;
+    default:                          index = 2 + _auxControlNumber; break;
+  }
+  index = constrain(index + delta, 0, AUX_SOURCE_STEPS - 1);
+  if (index == 0)      setAuxSource(AuxSource::CHANNEL_PRESSURE);
+  else if (index == 1) setAuxSource(AuxSource::VELOCITY);
+  else                 setAuxSource(AuxSource::CONTROL_CHANGE, index - 2);
+  _livePotDisplayValue = index * 100 / (AUX_SOURCE_STEPS - 1);
+
+  #if DEBUG_LEVEL >= 1
+  Serial.print("Mode 3: source aux ");
+  if (index == 0)      Serial.println("pression");
+  else if (index == 1) Serial.println("velocite");
+  else { Serial.print("CC "); Serial.println(index - 2); }
+  #endif
+}
+
+void EngineMode3::setPitchBendRange(uint8_t semitones) {
+  _bendRange = (semitones > PITCH_BEND_RANGE_MAX) ? PITCH_BEND_RANGE_MAX : semitones;
+  updatePitchCode();
+}
+
+void EngineMode3::setSharedAftertouchParams(float smoothingTime_ms) {
+  _auxSmoother.setTimeConstant(smoothingTime_ms);
+}
+
+void EngineMode3::setLatch(bool enabled) {
+  _latchEnabled = enabled;
+  if (_latchEnabled) return;
+  // Fin du latch: seules restent les notes dont le Note Off n'est pas encore arrivé
+  int kept = 0;
+  for (int i = 0; i < _stackCount; i++) {
+    if (!_stack[i].released) _stack[kept++] = _stack[i];
+  }
+  _stackCount = kept;
+  updateActiveNote(0);
+}
+
+// --- Sorties ---
+
+bool EngineMode3::getAndClearRetriggerEvent() {
+  bool e = _retriggerEvent;
+  _retriggerEvent = false;
+  if (e) { _outputOnset_us = _pendingOnset_us; _pendingOnset_us = 0; }
+  return e;
+}
+
+unsigned long EngineMode3::getAndClearOutputOnset() {
+  unsigned long t = _outputOnset_us;
+  _outputOnset_us = 0;
+  return t;
+}
+
+UIEffect EngineMode3::getAndClearRequestedEffect() {
+  UIEffect e = _uiEffectRequested;
+  _uiEffectRequested = UIEffect::NONE;
+  return e;
+}
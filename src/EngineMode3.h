@@ -5,29 +5,128 @@
 #include "HardwareConfig.h"
 #include "KeyboardData.h"
 #include "InputManager.h" 
+#include "PitchCalibration.h"
+#include "OnePoleSmoother.h"
+#include "RingBuffer.h"
 
+/**
+ * Mode 3: convertisseur MIDI vers CV monophonique.
+ *
+ * - Les messages reçus sont mis en file par les callbacks (onMidi*) et appliqués dans update(),
+ *   au plus MIDI_EVENTS_PER_UPDATE par appel
+ * - Pile de notes avec priorité au choix (dernière, plus grave, plus aiguë)
+ * - Pitch bend sur la CV de pitch, interpolé entre deux entrées de la table 1V/oct
+ * - Aux: pression de canal, vélocité ou un CC au choix, lissée comme l'aftertouch du mode 1
+ * - Legato: changement de note sans retrigger tant que la gate est ouverte
+ *
+ * Contrôles: OCT+/OCT- octave, HOLD latch, HOLD long legato, encodeur plage de bend,
+ * shift OCT+ + encodeur source aux, shift OCT- + encodeur priorité.
+ */
 class EngineMode3 {
 public:
-  EngineMode3() {}
-
-  // --- API Principale (Interface Vide) ---
-  void begin() {}
-  void update() {}
-  // CORRECTION: La signature correspond maintenant à celle de EngineMode1
-  void processInputs(const InputEvents& events, const bool* physicalKeyState) {}
-
-  void onMidiNoteOn(uint8_t pitch, uint8_t velocity) {}
-  void onMidiNoteOff(uint8_t pitch) {}
-
-  // --- GETTERS (Contrat d'Interface avec valeurs par défaut "sûres") ---
-  float getPitchVoltage() const { return PITCH_CV_CENTER_VOLTAGE; }
-  float getAuxVoltage() const { return 0.0f; }
-  bool  getGateState() const { return false; }
-  bool  getAndClearRetriggerEvent() { return false; }
-  int   getOctaveOffset() const { return 0; }
-  bool  isLatchActive() const { return false; }
-  int getLivePotDisplayValue() const { return 0; }
-  UIEffect getAndClearRequestedEffect() { return UIEffect::NONE; }
+  enum class NotePriority : uint8_t { LAST = 0, LOWEST, HIGHEST, COUNT };
+  enum class AuxSource : uint8_t { CHANNEL_PRESSURE = 0, VELOCITY, CONTROL_CHANGE };
+
+  EngineMode3();
+
+  // --- API Principale ---
+  // La table de calibration 1V/oct doit rester valide pendant toute la durée de vie du moteur
+  void begin(const PitchCalibration& pitchCal);
+  void update();
+  void handleInput(const InputEvent& event, const bool* physicalKeyState);
+
+  // --- Réception MIDI (callbacks): mise en file uniquement, appliquée au prochain update() ---
+  void onMidiNoteOn(uint8_t pitch, uint8_t velocity);
+  void onMidiNoteOff(uint8_t pitch);
+  void onMidiPitchBend(int bend);                    // -8192..8191
+  void onMidiControlChange(uint8_t number, uint8_t value);
+  void onMidiChannelPressure(uint8_t pressure);
+  // Changement de mode: vide la file et relâche toutes les notes
+  void reset();
+
+  // --- Réglages ---
+  void setNotePriority(NotePriority priority);
+  void setAuxSource(AuxSource source, uint8_t controlNumber = MIDI_AUX_CC_DEFAULT);
+  void setPitchBendRange(uint8_t semitones);
+  void setLegato(bool enabled) { _legato = enabled; }
+  // Partagé depuis EngineMode1, comme pour le mode 2
+  void setSharedAftertouchParams(float smoothingTime_ms);
+
+  // --- GETTERS (API de sortie) ---
+  uint16_t getPitchCode() const { return _pitchCode; }
+  float getAuxVoltage() const { return _currentAuxVoltage; }
+  bool  getGateState() const { return _gateOpen; }
+  bool  getAndClearRetriggerEvent();
+  unsigned long getAndClearOutputOnset();  // Réception du message à l'origine du retrigger, 0 sinon
+  int   getOctaveOffset() const { return _octaveOffset; }
+  bool  isLatchActive() const { return _latchEnabled; }
+  bool  isLegato() const { return _legato; }
+  int   getLivePotDisplayValue() const { return _livePotDisplayValue; }
+  UIEffect getAndClearRequestedEffect();
+  NotePriority getNotePriority() const { return _priority; }
+  uint8_t getPitchBendRange() const { return _bendRange; }
+  uint32_t getDroppedEvents() const { return _events.getDroppedCount(); }
+
+private:
+  enum class EventType : uint8_t { NOTE_ON, NOTE_OFF, PITCH_BEND, CONTROL_CHANGE, CHANNEL_PRESSURE };
+  struct Event {
+    EventType type;
+    uint8_t   data1;
+    uint8_t   data2;
+    uint32_t  time_us;   // Réception (micros()), pour la mesure MIDI -> sortie
+  };
+
+  struct HeldNote {
+    uint8_t pitch;
+    uint8_t velocity;
+    bool    released;    // Note Off reçu pendant le latch
+  };
+
+  void queueEvent(EventType type, uint8_t data1, uint8_t data2);
+  void applyEvent(const Event& event);
+  void noteOn(uint8_t pitch, uint8_t velocity, uint32_t time_us);
+  void noteOff(uint8_t pitch);
+  void removeNote(uint8_t pitch);
+  int  selectActiveNote() const;
+  void updateActiveNote(uint32_t time_us);
+  void updatePitchCode();
+  void updateAuxTarget();
+  void setLatch(bool enabled);
+  void stepAuxSource(int delta);
+
+  RingBuffer<Event, MIDI_EVENT_QUEUE_SIZE> _events;
+
+  // Pile dans l'ordre d'arrivée (la plus récente en haut)
+  HeldNote _stack[NOTE_STACK_SIZE];
+  int _stackCount;
+  int _activeIndex;          // -1 = aucune note
+  uint8_t _activePitch;
+
+  NotePriority _priority;
+  AuxSource _auxSource;
+  uint8_t _auxControlNumber;
+  uint8_t _bendRange;
+  bool _legato;
+  int _octaveOffset;
+  bool _latchEnabled;
+
+  // Sorties
+  const PitchCalibration* _pitchCal;
+  uint16_t _pitchCode;
+  int _bend;                  // -8192..8191
+  uint8_t _channelPressure;
+  uint8_t _controlValue;
+  float _targetAuxVoltage;
+  float _currentAuxVoltage;
+  OnePoleSmoother _auxSmoother;
+  unsigned long _lastUpdateTime_micros;
+  bool _gateOpen;
+  bool _retriggerEvent;
+  unsigned long _pendingOnset_us;
+  unsigned long _outputOnset_us;
+
+  int _livePotDisplayValue;
+  UIEffect _uiEffectRequested;
 };
 
-#endif // ENGINE_MODE_3_H
\ No newline at end of file
+#endif // ENGINE_MODE_3_H
@@ -9,6 +9,13 @@
 // =================================================================
 #define DEBUG_LEVEL 2
 
+// Profilage de loop() par étage (compteur de cycles DWT sur cible, horloge haute résolution sur PC).
+// Le relevé coûte une lecture du compteur et un incrément de case par étage; l'affichage
+// n'a lieu que sur commande série. 0 = appels vides.
+#define LOOP_PROFILER_ENABLED 1
+#define LOOP_PROFILER_DUMP_COMMAND  'p'  // Affiche les histogrammes
+#define LOOP_PROFILER_RESET_COMMAND 'r'  // Remet les histogrammes à zéro
+
 enum GameMode {
   MODE_PRESSURE_GLIDE,
   MODE_INTERVAL,
@@ -47,6 +54,9 @@ const uint8_t ADDR_MPR121_B = 0x5B;
 #define PIN_LED_c   D6
 #define PIN_LED_p   D5
 #define PIN_LED_pp  D3
+// Sorties IRQ des deux MPR121 (open-drain, actives à l'état bas) reliées ensemble sur une seule broche.
+// Utilisée seulement si KEYBOARD_IRQ_SCAN_ENABLED = 1 (voir section 3)
+#define PIN_MPR121_IRQ A4
 
 
 // =================================================================
@@ -54,9 +64,36 @@ const uint8_t ADDR_MPR121_B = 0x5B;
 // =================================================================
 #define I2C_CLOCK_HZ 400000
 
+// Ordonnanceur coopératif de loop(): base de temps du timer matériel et période de chaque tâche.
+// Les périodes sont arrondies à un multiple du tick. Le scan capteurs et le tick moteur ont la
+// même période: un appui détecté est rendu dans le même passage de l'ordonnanceur. Chaque scan
+// lit un seul capteur, en alternance A/B: touche tenue, son burst de 38 octets prend ~0,9 ms à
+// 400 kHz, soit presque toute la période; chaque moitié du clavier est relue toutes les 2 ms.
+#define SCHEDULER_TICK_HZ 4000
+const uint32_t SCHED_SENSOR_PERIOD_US = 1000;   // Scan d'un MPR121 + dispatch des appuis/relâchements
+const uint32_t SCHED_ENGINE_PERIOD_US = 1000;   // Tick de contrôle moteur + rendu DAC/gate
+const uint32_t SCHED_INPUT_PERIOD_US  = 1000;   // Boutons + encodeur (fronts comptés sous IRQ, polling en repli)
+const uint32_t SCHED_LED_PERIOD_US    = 10000;  // Trame LED (100 Hz)
+const uint32_t SCHED_MIDI_PERIOD_US   = 1000;   // Lecture du port MIDI (horloge, transport, notes)
+
+// Scan MPR121 piloté par IRQ: on ne lit que les 2 octets de statut tactile quand l'IRQ tombe,
+// et le burst complet (filtered + baseline) seulement pour le capteur dont le statut a changé
+// ou qui a une touche tenue. 0 = burst complet sur les deux capteurs à chaque boucle (ancien mode).
+// Désactivé par défaut: la liaison des sorties IRQ vers PIN_MPR121_IRQ n'est pas relevée sur le
+// PCB, et une mauvaise broche ne tomberait jamais (plus aucun appui vu). Ne passer à 1 qu'après
+// avoir vérifié le câblage; à 0 la broche n'est ni configurée ni attachée.
+#define KEYBOARD_IRQ_SCAN_ENABLED 0
+// Rafraîchissement forcé des baselines d'un capteur au repos (suit la dérive de l'autoconfig)
+const unsigned long KEYBOARD_IDLE_REFRESH_MS = 100;
+// Fenêtre de mesure des compteurs du clavier (octets I2C, publications d'aftertouch)
+const unsigned long KEYBOARD_STATS_WINDOW_MS = 1000;
+
 const int BUTTON_DEBOUNCE_MS = 30;
 const int MODE_BUTTON_LONG_PRESS_MS = 1000;
 const int HOLD_BUTTON_LONG_PRESS_MS = 1000;
+const int OCT_BUTTON_LONG_PRESS_MS = 500;    // Oct+/Oct- tenus au-delà: "shift" des réglages
+// File des événements d'entrée (boutons, encodeur, potentiomètre), vidée à chaque tick d'entrée
+#define INPUT_EVENT_QUEUE_SIZE 32         // Puissance de deux
 const int POT_DEADZONE = 4;
 
 const float POT_SENS_SMOOTHING_ALPHA = 0.05f;
@@ -64,7 +101,7 @@ const float POT_SENS_SMOOTHING_ALPHA = 0.05f;
 
 // Rotary Encoder Parameters
 const int ENCODER_STEPS_PER_DETENT = 4;  // Typical encoder has 4 state changes per click
-const unsigned long ENCODER_DEBOUNCE_TIME_MS = 2;  // Debounce time for encoder readings
+// No time debounce: edges are counted in interrupts, bounces cancel out in the accumulator
 
 // Arpeggiator Double-Tap Note Removal (Mode 2 Latch only)
 // Adjust this value (150-300ms recommended) to change double-tap sensitivity
@@ -127,6 +164,53 @@ constexpr const int8_t* SHUFFLE_TEMPLATES[5] = {
 const float SHUFFLE_DEPTH_MAX = 0.9f;  // Maximum 90% timing shift
 const float SHUFFLE_DEPTH_STEP = 0.005f; // 0.5% per encoder click (100 clicks = 4 turns for full sweep)
 
+// =================================================================
+// MIDI CLOCK SYNC (Mode 2)
+// =================================================================
+// One arp step = one beat = 24 MIDI clocks. While an external clock is received the arp
+// follows it (slave); otherwise it runs on its own tempo and sends the clock (master).
+#define MIDI_CLOCKS_PER_BEAT 24
+const uint32_t MIDI_CLOCK_TIMEOUT_US = 500000;   // No clock for this long = external clock lost
+const float MIDI_CLOCK_DLL_BANDWIDTH = 0.02f;     // Tempo tracking loop bandwidth, per tick (~2 beats)
+const float MIDI_CLOCK_MAX_ERROR_PERIODS = 0.75f; // Larger tick error = lost ticks, relock on the tick
+
+// =================================================================
+// MIDI VERS CV (Mode 3)
+// =================================================================
+// Les callbacks MIDI ne font que déposer les messages dans une file; le moteur en traite un
+// nombre borné par tick, et la tâche MIDI analyse un nombre borné d'octets par passage:
+// une rafale est étalée sur plusieurs ticks au lieu de bloquer le scan.
+#define MIDI_EVENT_QUEUE_SIZE 64                // Puissance de deux
+const uint8_t MIDI_EVENTS_PER_UPDATE = 16;      // Messages appliqués par tick moteur
+// Réception: octets relayés du port vers une file à chaque passage de loop()
+#define MIDI_RX_RING_SIZE 256                   // Puissance de deux
+const uint8_t MIDI_RX_BYTES_PER_TICK = 16;      // Octets analysés par passage de la tâche MIDI
+const uint8_t PITCH_BEND_RANGE_DEFAULT = 2;     // Demi-tons pour un bend maximal
+const uint8_t PITCH_BEND_RANGE_MAX = 24;
+const uint8_t MIDI_AUX_CC_DEFAULT = 1;          // Molette de modulation
+
+// =================================================================
+// MIDI OUT DU CLAVIER (Modes 1 et 2)
+// =================================================================
+// Notes et aftertouch polyphonique des touches capacitives, émis avec running status.
+// Les notes partent toujours; l'aftertouch d'une touche n'est émis que s'il a bougé d'au moins
+// AT_THRESHOLD (sur 0..127), au plus une fois par AT_MIN_INTERVAL, et tant que la ligne n'a pas
+// plus de MAX_BACKLOG d'octets en avance. Sinon la valeur attend, et une valeur plus récente la
+// remplace (fusion). 24 touches x 50/s x 2 octets = 77% des 31250 bauds: pas d'accumulation.
+const uint8_t  MIDI_OUT_CHANNEL = 1;
+const uint8_t  MIDI_OUT_NOTE_VELOCITY = 100;     // Pas de vélocité mesurée: la pression passe par l'aftertouch
+const uint32_t MIDI_OUT_BYTE_TIME_US = 320;      // 10 bits à 31250 bauds
+const uint8_t  MIDI_OUT_AT_THRESHOLD = 2;
+const uint32_t MIDI_OUT_AT_MIN_INTERVAL_US = 20000;
+const uint32_t MIDI_OUT_MAX_BACKLOG_US = 1000;   // ~3 octets en attente dans l'UART
+const unsigned long MIDI_OUT_STATS_WINDOW_MS = 1000;
+// MPE zone basse (bouton MODE, appui court): canal maître 1, un canal membre par touche tenue.
+// Pression par note en Channel Pressure sur le canal de la note, mêmes seuil/intervalle/budget.
+// Canal libéré le moins récemment réutilisé d'abord; sans canal libre, la note la plus ancienne
+// cède le sien.
+const uint8_t  MPE_MASTER_CHANNEL = 1;           // Zone basse: toujours le canal 1
+const uint8_t  MPE_MEMBER_CHANNELS = 15;         // Canaux 2 à 16
+
 // =================================================================
 // ENCODER ACCELERATION CURVES (Velocity-Based Control)
 // =================================================================
@@ -144,12 +228,19 @@ const float GLIDE_STEP_MAX = 50.0f;     // Fast sweep at high speed (50ms per ti
 const float GLIDE_ACCEL_CURVE = 2.2f;   // Acceleration curve (1.0=linear, 2.0=quadratic, higher=more aggressive)
 
 // BPM Control (5-900 range)
+const uint16_t ARP_BPM_MIN = 5;
+const uint16_t ARP_BPM_MAX = 900;
 const float BPM_STEP_MIN = 0.5f;        // Ultra-precise at slow speed (0.5 BPM per tick)
 const float BPM_STEP_MAX = 35.0f;       // Fast at high speed (35 BPM per tick)
 const float BPM_ACCEL_CURVE = 1.8f;     // Slightly gentler curve than glide
 
 #define DAC_I2C_ADDR 0x5F
 #define CV_OUTPUT_RESOLUTION 4095
+// Calibration volts -> code par défaut des deux canaux (DAC idéal: 0V = code 0, 10V = 4095)
+#define DAC_DEFAULT_OFFSET_CODE    0
+#define DAC_DEFAULT_CODES_PER_VOLT (CV_OUTPUT_RESOLUTION / DAC_OUTPUT_VOLTAGE_RANGE)
+// Fenêtre de mesure des compteurs d'écriture du DAC (transactions, octets, octets économisés)
+const unsigned long DAC_STATS_WINDOW_MS = 1000;
 
 
 // =================================================================
@@ -176,24 +267,42 @@ const float GLIDE_MAX_TIME_MS = 1000.0f;
 
 #define MAX_OCTAVE 2
 #define MIN_OCTAVE -2
-const int TRIGGER_PULSE_DURATION_MS = 5;
+const uint32_t TRIGGER_PULSE_DURATION_US = 5000;
 
 #define AFTERTOUCH_CURVE_EXP_INTENSITY 4.0f
 #define AFTERTOUCH_CURVE_SIG_INTENSITY 2
+// Table de la courbe de réponse: 2^BITS segments interpolés linéairement
+#define RESPONSE_CURVE_LUT_BITS 8
+#define RESPONSE_CURVE_LUT_SIZE (1 << RESPONSE_CURVE_LUT_BITS)
 
+// Fenêtre de la moyenne mobile (somme glissante: coût constant, 16-32 possible pour un aftertouch plus doux)
 #define AFTERTOUCH_SMOOTHING_WINDOW_SIZE 4
+// Chaîne normalisation -> courbe -> slew -> moyenne en virgule fixe (Q15) au lieu de float.
+// 0 = chemin flottant d'origine (référence).
+#define AFTERTOUCH_FIXED_POINT 1
 #define AFTERTOUCH_SLEW_RATE_LIMIT 150
 
+// Publication de l'aftertouch vers les moteurs: une touche tenue n'est signalée que si sa pression
+// a bougé d'au moins DEADBAND (sur 0..4095), ou a bougé tout court depuis MAX_INTERVAL_MS.
+const uint16_t AFTERTOUCH_DISPATCH_DEADBAND = 8;
+const uint16_t AFTERTOUCH_DISPATCH_MAX_INTERVAL_MS = 20;
+
 // -- ETAGE 2: Lissage Musical (dans EngineMode1) --
 // Rôle: Créer des transitions douces de l'aftertouch entre deux notes jouées en legato.
 // C'est le "Glide" de l'aftertouch. C'est ce paramètre qui a le plus d'impact sur la sensation de jeu legato.
-#define AUX_VOLTAGE_SMOOTHING_ALPHA_DEFAULT 0.1f // La valeur par défaut au démarrage
-#define AUX_SMOOTHING_MIN_ALPHA 0.001f           // Lissage max (temps très long), contrôlé par potard
-#define AUX_SMOOTHING_MAX_ALPHA 0.9f             // Lissage min (quasi instantané), contrôlé par potard
-// Technique: Coefficient du filtre passe-bas (0.0 à 1.0).
-// Plage: 0.05 (très lent) à 0.3 (rapide).
-// -> Diminuer (vers 0.0): La transition de pression entre deux notes sera très lente et douce.
-// -> Augmenter (vers 1.0): La transition sera quasi instantanée et abrupte.
+#define AUX_SMOOTHING_TIME_DEFAULT_MS 3.0f    // La valeur par défaut au démarrage
+#define AUX_SMOOTHING_MIN_TIME_MS 0.5f        // Lissage min (quasi instantané), contrôlé par l'encodeur
+#define AUX_SMOOTHING_MAX_TIME_MS 500.0f      // Lissage max (temps très long), contrôlé par l'encodeur
+#define AUX_SMOOTHING_ENCODER_STEPS 100       // Crans de l'encodeur de MIN à MAX (progression géométrique)
+// Technique: Constante de temps du filtre passe-bas (OnePoleSmoother), en ms de temps réel:
+// la sensation ne dépend plus de la vitesse de la boucle.
+// -> Augmenter: La transition de pression entre deux notes sera très lente et douce.
+// -> Diminuer: La transition sera quasi instantanée et abrupte.
+
+// Table exp(-x) des lissages à un pôle: 2^BITS segments sur x = 0..RANGE (au-delà: cible atteinte)
+#define ONE_POLE_LUT_BITS 8
+#define ONE_POLE_LUT_SIZE (1 << ONE_POLE_LUT_BITS)
+#define ONE_POLE_LUT_RANGE 8.0f
 
 const int AFTERTOUCH_DEADZONE_MAX_OFFSET = 250;
 
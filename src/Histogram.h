@@ -0,0 +1,83 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Histogramme à cases fixes pour des durées (en ticks) sur 32 bits.
+ *
+ * - Cases log-linéaires: 0-7 exactes, puis 4 cases par octave (erreur relative < 25%)
+ * - Enregistrement en temps constant: un clz, deux décalages, un incrément
+ * - Au-delà de 2^28 ticks, tout tombe dans la dernière case
+ * - Les percentiles renvoient la borne haute de la case, bornée par le max observé
+ */
+class Histogram {
+public:
+  static const uint8_t NUM_BUCKETS = 108;
+
+  Histogram() {
+    reset();
+  }
+
+  void reset() {
+    memset(_buckets, 0, sizeof(_buckets));
+    _count = 0;
+    _min = 0xFFFFFFFF;
+    _max = 0;
+  }
+
+  void record(uint32_t value) {
+    _buckets[bucketIndex(value)]++;
+    _count++;
+    if (value < _min) _min = value;
+    if (value > _max) _max = value;
+  }
+
+  uint32_t count() const { return _count; }
+  uint32_t minimum() const { return _count ? _min : 0; }
+  uint32_t maximum() const { return _max; }
+  uint32_t bucketCount(uint8_t index) const { return _buckets[index]; }
+
+  /**
+   * Valeur sous laquelle se trouvent `permille` ‰ des échantillons (500 = médiane, 990 = p99)
+   */
+  uint32_t percentile(uint16_t permille) const {
+    if (_count == 0) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)_count * permille + 999) / 1000);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < NUM_BUCKETS; i++) {
+      seen += _buckets[i];
+      if (seen >= rank) {
+        if (i == NUM_BUCKETS - 1) return _max;
+        uint32_t upper = bucketUpperBound(i);
+        return upper < _max ? upper : _max;
+      }
+    }
+    return _max;
+  }
+
+  static uint8_t bucketIndex(uint32_t value) {
+    if (value < 8) return value;
+    uint8_t exponent = 31 - __builtin_clz(value);
+    if (exponent > 27) return NUM_BUCKETS - 1;
+    uint8_t mantissa = (value >> (exponent - 2)) & 0x03;
+    return 8 + (exponent - 3) * 4 + mantissa;
+  }
+
+  static uint32_t bucketUpperBound(uint8_t index) {
+    if (index < 8) return index;
+    uint8_t exponent = 3 + (index - 8) / 4;
+    uint8_t mantissa = (index - 8) % 4;
+    return ((uint32_t)(4 + mantissa + 1) << (exponent - 2)) - 1;
+  }
+
+private:
+  uint32_t _buckets[NUM_BUCKETS];
+  uint32_t _count;
+  uint32_t _min;
+  uint32_t _max;
+};
+
+#endif // HISTOGRAM_H
@@ -3,63 +3,78 @@
 
 #include "HardwareConfig.h"
 #include "SimpleEncoder.h"
+#include "RingBuffer.h"
 #include <JC_Button.h>
 
-struct InputEvents {
-  // --- Événements de Boutons ---
-  bool hold_wasPressedShort;
-  bool hold_wasPressedLong;
-  bool mode_wasPressedShort;
-  bool mode_wasPressedLong;
-  // RESTAURATION: Ce nom est plus clair et correct
-  bool octPlus_wasReleasedAsShort;
-  bool octMinus_wasReleasedAsShort;
-  
-  // États des boutons "shift"
-  bool octPlus_isPressed;
-  bool octMinus_isPressed;
-  bool octPlus_isLongPressed;
-  bool octMinus_isLongPressed;
+enum class InputEventType : uint8_t {
+  // --- Boutons ---
+  HOLD_SHORT,          // Relâché avant l'appui long
+  HOLD_LONG,           // Appui long atteint (bouton encore enfoncé)
+  MODE_SHORT,
+  MODE_LONG,
+  OCT_PLUS_SHORT,      // Relâché avant de devenir "shift"
+  OCT_MINUS_SHORT,
+  // États "shift": Oct+/Oct- tenus au-delà de l'appui long, jusqu'au relâchement
+  SHIFT_PLUS_DOWN,
+  SHIFT_PLUS_UP,
+  SHIFT_MINUS_DOWN,
+  SHIFT_MINUS_UP,
 
-  // --- Mouvements de Contrôleurs ---
-  bool sens_potMoved;
-  bool live_encoderTurned;     // Replaces live_potMoved
-  int potSensValue; 
-  int live_encoderDelta;       // Replaces potLiveValue - contains +1, -1, or 0
-  int live_encoderVelocity;    // Speed of encoder turning (0-20, for acceleration)
+  // --- Contrôleurs ---
+  ENCODER,             // value = pas signés, velocity = vitesse (0-ENCODER_VELOCITY_MAX)
+  POT_SENS             // value = position lissée (0-1023)
+};
+
+// Modificateurs actifs au moment de l'événement (bits de InputEvent::modifiers)
+const uint8_t INPUT_MOD_SHIFT_PLUS  = 0x01;
+const uint8_t INPUT_MOD_SHIFT_MINUS = 0x02;
 
-  // --- Événements de Combinaisons ---
-  bool combo_OctPlus_LiveMoved;
-  bool combo_OctMinus_LiveMoved;
+// Un enregistrement par événement, horodaté en micros() (front de l'encodeur, détection sinon)
+struct InputEvent {
+  uint32_t       time_us;
+  int16_t        value;
+  InputEventType type;
+  uint8_t        modifiers;
+  uint8_t        velocity;
 };
 
 class InputManager {
 public:
   InputManager();
   void begin();
+
+  // Lit boutons, encodeur et potentiomètre; chaque changement devient un événement en file
   void update();
-  const InputEvents& getEvents() const;
+
+  // Consommation dans l'ordre d'arrivée; false quand la file est vide
+  bool popEvent(InputEvent& event);
+  uint32_t getDroppedEventCount() const { return _queue.getDroppedCount(); }
+
   static bool isHoldPressedOnBoot();
 
 private:
+  void postEvent(InputEventType type, uint32_t time_us, int16_t value = 0, uint8_t velocity = 0);
+  void updateOctaveButton(Button& button, bool& longPressTriggered, uint8_t modifier,
+                          InputEventType shortType, InputEventType shiftDown,
+                          InputEventType shiftUp, uint32_t now_us);
+
   Button _btnHold;
   Button _btnMode;
   Button _btnOctPlus;
   Button _btnOctMinus;
-  InputEvents _events; 
-  SimpleEncoder _liveEncoder;  // Replaces pot_live
+  RingBuffer<InputEvent, INPUT_EVENT_QUEUE_SIZE> _queue;
+  SimpleEncoder _liveEncoder;  // Interrupt-driven, read once per update
   float _smoothedPotSens;
   int _lastPotSensSent;
   bool _holdLongPressTriggered;
   bool _modeLongPressTriggered;
-  bool _octPlus_comboHappened;
-  bool _octMinus_comboHappened;
   bool _octPlus_longPressTriggered;
   bool _octMinus_longPressTriggered;
-  
+  uint8_t _modifiers;          // INPUT_MOD_* courants
+
   // Encoder velocity tracking
-  unsigned long _encoderLastTurnTime;
+  uint32_t _encoderLastEdgeMicros;  // Edge timestamp of the last step taken
   float _encoderVelocity;  // Smoothed velocity value
 };
 
-#endif // INPUT_MANAGER_H
\ No newline at end of file
+#endif // INPUT_MANAGER_H
@@ -2,6 +2,7 @@
 #include "CapacitiveKeyboard.h"
 #include "LedManager.h"
 #include "DACManager.h"
+#include "PitchCalibration.h"
 #include "KeyboardData.h"
 #include "HardwareConfig.h"
 
@@ -12,6 +13,10 @@ const uint16_t sensitivityTargets[] = { 550, 650, 750, 850, 900 };
 const char* sensitivityNames[] = {"Standard", "Sensible", "Tres Sensible", "Haute Perf.", "Gain Max"};
 const int NUM_SENSITIVITY_LEVELS = sizeof(sensitivityTargets) / sizeof(uint16_t);
 
+// Phase 4 (1V/oct): répétition automatique des boutons OCT+/- pour l'ajustement fin du code
+const uint32_t PITCH_CAL_REPEAT_DELAY_MS = 400;
+const uint32_t PITCH_CAL_REPEAT_PERIOD_MS = 40;
+
 
 KeyboardCalibrator::KeyboardCalibrator() {
   // Constructeur vide
@@ -21,6 +26,7 @@ void KeyboardCalibrator::run(
   CapacitiveKeyboard &keyboard, 
   LedManager &leds,
   DACManager &dac,
+  PitchCalibration &pitchCal,
   Button &holdBtn, 
   Button &modeBtn, 
   Button &octPlusBtn, 
@@ -54,6 +60,8 @@ void KeyboardCalibrator::run(
     STATE_MEASURE_KEY, 
     STATE_WAIT_RELEASE_AFTER_MEASURE, 
     STATE_FINAL_CONFIRMATION,
+    STATE_PITCH_CAL_PREPARE,
+    STATE_PITCH_CAL_TRIM,
     STATE_SAVE_EXIT, 
     STATE_FINISHED 
   };
@@ -67,6 +75,10 @@ void KeyboardCalibrator::run(
   uint16_t measuredDeltas[NUM_KEYS];
   uint16_t currentMaxDelta = 0, lastPrintedMaxDelta = 0;
   unsigned long lastPrintTime = 0;
+  uint8_t pitchPoint = 0;
+  bool pitchCalModified = false;
+  bool pitchPointPrinted = false;
+  unsigned long lastRepeatTime = 0;
 
   Serial.println("[FSM] Lancement de la machine a etats de calibration...");
 
@@ -214,6 +226,7 @@ void KeyboardCalibrator::run(
           Serial.println("\n-------------------------------------------");
           Serial.println("\n[ACTION] Appuyer sur HOLD pour Sauvegarder et Quitter.");
           Serial.println("[ACTION] Appuyer sur MODE pour Recommencer la Calibration.");
+          Serial.println("[ACTION] Appuyer sur OCT+ pour Calibrer la sortie Pitch (1V/oct, voltmetre requis).");
           recapDisplayed = true;
         }
 
@@ -223,6 +236,78 @@ void KeyboardCalibrator::run(
         if (modeBtn.wasPressed()) {
           currentState = STATE_INIT;
         }
+        if (octPlusBtn.wasPressed()) {
+          currentState = STATE_PITCH_CAL_PREPARE;
+        }
+        break;
+
+      case STATE_PITCH_CAL_PREPARE:
+        Serial.println("[FSM] -> ETAT: STATE_PITCH_CAL_PREPARE");
+        Serial.println("\n=== Phase 4: Calibration 1V/oct de la sortie Pitch ===");
+        // Le DAC n'est normalement initialisé qu'après la calibration
+        if (!dac.begin(DAC_I2C_ADDR, Wire1)) {
+          Serial.println("[CAL] ERREUR: DAC absent, calibration 1V/oct impossible.");
+          recapDisplayed = false;
+          currentState = STATE_FINAL_CONFIRMATION;
+          break;
+        }
+        Serial.println("Mesurer la sortie Pitch et ajuster le code jusqu'a la tension affichee.");
+        Serial.println("ACTIONS:");
+        Serial.println("  - OCT+ / OCT- : Code +1 / -1 (maintenir pour repeter).");
+        Serial.println("  - MODE        : Point suivant (0V -> 10V). LEDs = tension du point en binaire.");
+        Serial.println("  - HOLD        : Valider les points et revenir a la confirmation finale.");
+        pitchPoint = 0;
+        pitchPointPrinted = false;
+        leds.displayStaticPattern(pitchPoint, true);
+        currentState = STATE_PITCH_CAL_TRIM;
+        break;
+
+      case STATE_PITCH_CAL_TRIM:
+        {
+          int code = pitchCal.getOctaveCode(pitchPoint);
+          int step = 0;
+          if (octPlusBtn.wasPressed()) step = 1;
+          if (octMinusBtn.wasPressed()) step = -1;
+          if (millis() - lastRepeatTime >= PITCH_CAL_REPEAT_PERIOD_MS) {
+            if (octPlusBtn.pressedFor(PITCH_CAL_REPEAT_DELAY_MS)) step = 1;
+            if (octMinusBtn.pressedFor(PITCH_CAL_REPEAT_DELAY_MS)) step = -1;
+            if (step != 0) lastRepeatTime = millis();
+          }
+          if (step != 0) {
+            code = constrain(code + step, 0, CV_OUTPUT_RESOLUTION);
+            pitchCal.setOctaveCode(pitchPoint, code);
+            pitchCalModified = true;
+            pitchPointPrinted = false;
+          }
+          dac.setOutputCode(0, code);
+
+          if (!pitchPointPrinted) {
+            Serial.print("  -> Point "); Serial.print(pitchPoint); Serial.print("V : code ");
+            Serial.print(code); Serial.print(" (ideal "); Serial.print(PitchCalibration::idealOctaveCode(pitchPoint));
+            Serial.println(")");
+            pitchPointPrinted = true;
+          }
+        }
+
+        if (modeBtn.wasPressed()) {
+          pitchPoint = (pitchPoint + 1) % PITCH_CAL_NUM_POINTS;
+          pitchPointPrinted = false;
+          leds.displayStaticPattern(pitchPoint, true);
+        }
+
+        if (holdBtn.wasPressed()) {
+          leds.playValidation(100, 2);
+          pitchCal.rebuildTable();
+          dac.setOutputVoltage(0, 0.0f);
+          Serial.print("[CAL] Points 1V/oct valides:");
+          for (uint8_t i = 0; i < PITCH_CAL_NUM_POINTS; i++) {
+            Serial.print(" "); Serial.print(pitchCal.getOctaveCode(i));
+          }
+          Serial.println();
+          while(holdBtn.isPressed()){ holdBtn.read(); delay(5); }
+          recapDisplayed = false;
+          currentState = STATE_FINAL_CONFIRMATION;
+        }
         break;
 
       case STATE_SAVE_EXIT:
@@ -231,6 +316,10 @@ void KeyboardCalibrator::run(
         keyboard.calculateAdaptiveThresholds();
         leds.playValidation(180, 3);
         keyboard.saveCalibrationData();
+        if (pitchCalModified) {
+          pitchCal.save();
+          Serial.println("[CAL] SAVE: Calibration 1V/oct enregistree.");
+        }
         Serial.println("[CAL] SAVE: EEPROM ok. Retour au JEU.");
         leds.exitCalibrationMode();
         currentState = STATE_FINISHED;
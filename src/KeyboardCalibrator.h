@@ -6,6 +6,7 @@ class CapacitiveKeyboard;
 class LedManager;
 class Button;
 class DACManager;
+class PitchCalibration;
 
 /**
  * @class KeyboardCalibrator
@@ -20,6 +21,7 @@ public:
    * @param keyboard Référence vers l'instance du moteur clavier à calibrer.
    * @param leds Référence vers le gestionnaire de LEDs pour le retour visuel.
    * @param dac Référence vers le gestionnaire de DAC pour le mettre à zéro.
+   * @param pitchCal Points de correction 1V/oct (phase 4 optionnelle), sauvegardés avec le clavier.
    * @param holdBtn Référence vers le bouton HOLD.
    * @param modeBtn Référence vers le bouton MODE.
    * @param octPlusBtn Référence vers le bouton OCT+.
@@ -29,6 +31,7 @@ public:
     CapacitiveKeyboard &keyboard, 
     LedManager &leds,
     DACManager &dac,
+    PitchCalibration &pitchCal,
     Button &holdBtn, 
     Button &modeBtn, 
     Button &octPlusBtn, 
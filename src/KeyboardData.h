@@ -17,6 +17,19 @@ struct Note {
   uint16_t value; // Pression ou vélocité
 };
 
+// =================================================================
+// Masques de touches
+// =================================================================
+static_assert(NUM_KEYS <= 32, "Les masques de touches tiennent sur un uint32_t");
+
+// Renvoie l'index du bit de poids faible et l'efface du masque (masque non nul).
+// Permet de ne visiter que les touches concernées: coût nul quand le clavier est au repos.
+inline int popLowestKey(uint32_t& mask) {
+  int key = __builtin_ctz(mask);
+  mask &= mask - 1;
+  return key;
+}
+
 // =================================================================
 // Constantes et Structure de Données de Calibration
 // =================================================================
@@ -34,5 +47,23 @@ struct CalDataStore {
   uint16_t maxDelta[NUM_KEYS]; // Utilise NUM_KEYS défini dans HardwareConfig.h
 };
 
+// =================================================================
+// Calibration 1V/oct de la sortie Pitch
+// =================================================================
+// Un point de correction par octave (0V, 1V ... 10V): code DAC mesuré pour chaque tension.
+// Stocké juste après CalDataStore, avec ses propres magic/version: une calibration clavier
+// existante reste valide, et inversement.
+const uint8_t  PITCH_CAL_NUM_POINTS = 11;
+const uint16_t PITCH_CAL_MAGIC      = 0xC0DE;
+const uint8_t  PITCH_CAL_VERSION    = 1;
+const int      EEPROM_PITCH_CAL_ADDR = sizeof(CalDataStore);
+
+struct PitchCalStore {
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  reserved;
+  uint16_t octaveCode[PITCH_CAL_NUM_POINTS];
+};
+
 
 #endif // KEYBOARD_DATA_H
\ No newline at end of file
@@ -8,6 +8,13 @@
 #include "EngineMode2.h"
 #include "EngineMode3.h"
 #include "InputManager.h"
+#include "LoopProfiler.h"
+#include "PitchCalibration.h"
+#include "ControlScheduler.h"
+#include "PulseOutputs.h"
+#include "MidiClockSync.h"
+#include "MidiKeyboardOut.h"
+#include "MidiRxTransport.h"
 #include <JC_Button.h>
 #include <Arduino.h>
 #include <MIDI.h>
@@ -22,6 +29,12 @@ CapacitiveKeyboard keyboard;
 DACManager         dac;
 InputManager       inputManager;
 LedController      ledController;
+LoopProfiler       loopProfiler;
+PitchCalibration   pitchCalibration;
+ControlScheduler   scheduler;
+PulseOutputs       pulses;
+MidiClockSync      midiClock;
+MidiKeyboardOut    keyboardMidiOut;
 
 EngineMode1 engine1;
 EngineMode2 engine2;
@@ -29,27 +42,75 @@ EngineMode3 engine3;
 
 GameMode currentMode = MODE_PRESSURE_GLIDE;
 
+// Tâches de l'ordonnanceur (section 5)
+void taskMidi();
+void taskInput();
+void taskSensors();
+void taskEngine();
+void taskLeds();
+
 // Instances de boutons conservées UNIQUEMENT pour le KeyboardCalibrator
 Button btnHold(PIN_BTN_HOLD, BUTTON_DEBOUNCE_MS);
 Button btnMode(PIN_BTN_MODE, BUTTON_DEBOUNCE_MS);
 Button btnOctPlus(PIN_BTN_OCT_PLUS, BUTTON_DEBOUNCE_MS);
 Button btnOctMinus(PIN_BTN_OCT_MINUS, BUTTON_DEBOUNCE_MS);
 
-MIDI_CREATE_INSTANCE(HardwareSerial, Serial, MIDI);
+// Running status en émission: le flux du clavier (Note On / aftertouch) économise un octet sur trois
+struct KeyboardMidiSettings : public midi::DefaultSettings {
+  static const bool UseRunningStatus = true;
+};
+// Réception par file relayée à chaque passage de loop() (MidiRxTransport), analyse bornée dans taskMidi()
+MidiRxTransport midiTransport(Serial);
+midi::MidiInterface<MidiRxTransport, KeyboardMidiSettings> MIDI(midiTransport);
+
+#if LOOP_PROFILER_ENABLED
+// Commande reconnue par le transport, exécutée par loop() hors des tâches mesurées
+int pendingDebugCommand = -1;
+bool queueDebugCommand(uint8_t command) {
+  if (command != LOOP_PROFILER_DUMP_COMMAND && command != LOOP_PROFILER_RESET_COMMAND) return false;
+  pendingDebugCommand = command;
+  return true;
+}
+#endif
+
+void sendKeyboardMidi(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2) {
+  MIDI.send((midi::MidiType)type, data1, data2, channel);
+}
 
 // =================================================================
 // 2. Fonctions de Rappel MIDI (Callbacks)
 // =================================================================
+// Messages de canal: mis en file pour EngineMode3, appliqués au tick moteur
 void handleMidiNoteOn(byte channel, byte pitch, byte velocity) {
   if (currentMode == MODE_MIDI) {
-    // engine3.onMidiNoteOn(pitch, velocity);
+    engine3.onMidiNoteOn(pitch, velocity);
   }
 }
 void handleMidiNoteOff(byte channel, byte pitch, byte velocity) {
   if (currentMode == MODE_MIDI) {
-    // engine3.onMidiNoteOff(pitch);
+    engine3.onMidiNoteOff(pitch);
   }
 }
+void handleMidiPitchBend(byte channel, int bend) {
+  if (currentMode == MODE_MIDI) {
+    engine3.onMidiPitchBend(bend);
+  }
+}
+void handleMidiControlChange(byte channel, byte number, byte value) {
+  if (currentMode == MODE_MIDI) {
+    engine3.onMidiControlChange(number, value);
+  }
+}
+void handleMidiChannelPressure(byte channel, byte pressure) {
+  if (currentMode == MODE_MIDI) {
+    engine3.onMidiChannelPressure(pressure);
+  }
+}
+// Horloge et transport: suivis dans tous les modes, l'arpège les retrouve verrouillés
+void handleMidiClock()    { midiClock.onClock(micros()); }
+void handleMidiStart()    { midiClock.onStart(); }
+void handleMidiContinue() { midiClock.onContinue(); }
+void handleMidiStop()     { midiClock.onStop(); }
 
 // =================================================================
 // 3. SETUP
@@ -63,8 +124,9 @@ void setup() {
 #endif
 
   ledController.begin();
-  pinMode(PIN_GATE, OUTPUT);
-  pinMode(PIN_TRIGGER, OUTPUT);
+  if (!pulses.begin()) {
+    while(1) { /* Gestion erreur critique */ }
+  }
   
   btnHold.begin();
   btnMode.begin();
@@ -90,11 +152,13 @@ void setup() {
 #endif
   delay(100);  // Allow I2C clock to stabilize
   
+  pitchCalibration.begin();
+
   if (InputManager::isHoldPressedOnBoot()) {
     LedManager tempLedManager;
     tempLedManager.begin();
     KeyboardCalibrator calibrator;
-    calibrator.run(keyboard, tempLedManager, dac, btnHold, btnMode, btnOctPlus, btnOctMinus);
+    calibrator.run(keyboard, tempLedManager, dac, pitchCalibration, btnHold, btnMode, btnOctPlus, btnOctMinus);
   }
   
 #if DEBUG_LEVEL >= 0
@@ -129,13 +193,37 @@ void setup() {
     while(1) { /* Gestion erreur critique */ }
   }
 
-  engine1.begin();
-  engine2.begin();
-  engine3.begin();
+  engine1.begin(pitchCalibration);
+  engine2.begin(pitchCalibration);
+  engine2.setClockSync(&midiClock);
+  engine3.begin(pitchCalibration);
   
   MIDI.setHandleNoteOn(handleMidiNoteOn);
   MIDI.setHandleNoteOff(handleMidiNoteOff);
+  MIDI.setHandlePitchBend(handleMidiPitchBend);
+  MIDI.setHandleControlChange(handleMidiControlChange);
+  MIDI.setHandleAfterTouchChannel(handleMidiChannelPressure);
+  MIDI.setHandleClock(handleMidiClock);
+  MIDI.setHandleStart(handleMidiStart);
+  MIDI.setHandleContinue(handleMidiContinue);
+  MIDI.setHandleStop(handleMidiStop);
   MIDI.begin(MIDI_CHANNEL_OMNI);
+  MIDI.turnThruOff();  // L'horloge reçue ne doit pas repartir vers le maître
+#if LOOP_PROFILER_ENABLED
+  midiTransport.setCommandHandler(queueDebugCommand);
+#endif
+  keyboardMidiOut.begin(sendKeyboardMidi);
+
+  loopProfiler.begin();
+
+  if (!scheduler.begin(SCHEDULER_TICK_HZ)) {
+    while(1) { /* Gestion erreur critique */ }
+  }
+  scheduler.addTask("midi", taskMidi, SCHED_MIDI_PERIOD_US);
+  scheduler.addTask("input", taskInput, SCHED_INPUT_PERIOD_US);
+  scheduler.addTask("capteurs", taskSensors, SCHED_SENSOR_PERIOD_US);
+  scheduler.addTask("moteur", taskEngine, SCHED_ENGINE_PERIOD_US);
+  scheduler.addTask("leds", taskLeds, SCHED_LED_PERIOD_US);
 
   #if DEBUG_LEVEL >= 0
   Serial.println("Pret a jouer.");
@@ -148,95 +236,218 @@ void setup() {
 
 void transitionToMode(GameMode newMode) {
   if (newMode == currentMode) return;
-  digitalWrite(PIN_GATE, LOW);
-  digitalWrite(PIN_TRIGGER, LOW);
+  pulses.clear();
   dac.setOutputVoltage(1, 0.0f);
+  // Notes MIDI tenues ou en file: sans objet hors du mode 3, et périmées en y revenant
+  engine3.reset();
+  // Le mode 3 n'émet rien depuis le clavier: les notes tenues sont closes côté récepteur
+  if (newMode == MODE_MIDI) keyboardMidiOut.releaseAll(micros());
   currentMode = newMode;
 }
 
-void renderAudioOutputs(float pitchV, float auxV, bool gateState, bool retrigger) {
-  dac.setOutputVoltage(0, pitchV);
-  dac.setOutputVoltage(1, auxV);
-  
-  static unsigned long triggerEndTime = 0;
-  static bool triggerActive = false;
+void renderAudioOutputs(uint16_t pitchCode, float auxV, bool gateState, uint32_t gateLength_us,
+                        bool retrigger, unsigned long onsetTime_us) {
+  // Pitch: code déjà corrigé par la table 1V/oct; Aux: calibration linéaire du canal 1
+  dac.setOutputCodes(pitchCode, dac.voltsToCode(1, auxV));
+
+  // Fronts descendants posés par le timer de PulseOutputs: largeurs exactes quelle que soit la charge
+  uint32_t now = micros();
   if (retrigger) {
-    digitalWrite(PIN_TRIGGER, HIGH);
-    triggerEndTime = millis() + TRIGGER_PULSE_DURATION_MS;
-    triggerActive = true;
+    pulses.schedulePulse(PulseOutputs::TRIGGER, now, TRIGGER_PULSE_DURATION_US);
+  }
+  if (gateLength_us > 0) {
+    // Arpège: une impulsion de gate par pas, la gate tenue d'avant l'arpège est relâchée
+    if (retrigger) {
+      pulses.schedulePulse(PulseOutputs::GATE, now, gateLength_us);
+    } else if (!pulses.isPending(PulseOutputs::GATE)) {
+      pulses.setLevel(PulseOutputs::GATE, false);
+    }
+  } else {
+    pulses.setLevel(PulseOutputs::GATE, gateState);
   }
-  if (triggerActive && millis() >= triggerEndTime) {
-    digitalWrite(PIN_TRIGGER, LOW);
-    triggerActive = false;
+
+  // L'appui à l'origine de ce retrigger est maintenant sur le DAC et la gate
+  if (onsetTime_us != 0) {
+    loopProfiler.recordKeyToOutput(currentMode, micros() - onsetTime_us);
   }
-  digitalWrite(PIN_GATE, gateState);
 }
 
 // =================================================================
-// 5. LOOP PRINCIPALE
+// 5. TACHES DE L'ORDONNANCEUR
 // =================================================================
-void loop() {
+// Ordre d'enregistrement = ordre d'exécution dans un passage: MIDI, entrées, capteurs, moteur, LEDs.
+// Chaque tâche attribue son temps à un étage du LoopProfiler.
+
+void taskMidi() {
+  // Les ticks d'horloge sont horodatés à l'analyse, avant le tick moteur. Un octet par
+  // MIDI.read(), nombre borné par passage: une rafale reste en file au lieu de retarder le scan
+  for (uint8_t n = 0; n < MIDI_RX_BYTES_PER_TICK && midiTransport.available(); n++) {
+    MIDI.read();
+  }
+  loopProfiler.mark(LoopStage::MIDI_INPUT);
+}
+
+void taskInput() {
   inputManager.update();
-  const InputEvents& events = inputManager.getEvents();
+
+  // Événements dans l'ordre d'arrivée: un changement de mode s'applique aux suivants
+  const bool* physicalKeyState = keyboard.getPressedKeysState();
+  InputEvent event;
+  while (inputManager.popEvent(event)) {
+    if (event.type == InputEventType::MODE_LONG) {
+      int nextModeIndex = ((int)currentMode + 1) % 3;
+      transitionToMode((GameMode)nextModeIndex);
+    }
+    // Appui court: sortie MIDI du clavier en aftertouch polyphonique ou en MPE zone basse
+    if (event.type == InputEventType::MODE_SHORT && currentMode != MODE_MIDI) {
+      bool toMpe = keyboardMidiOut.getOutputMode() == MidiOutMode::POLY_AFTERTOUCH;
+      keyboardMidiOut.setOutputMode(toMpe ? MidiOutMode::MPE_LOWER_ZONE : MidiOutMode::POLY_AFTERTOUCH, micros());
+    }
+
+    switch (currentMode) {
+      case MODE_PRESSURE_GLIDE: engine1.handleInput(event, physicalKeyState); break;
+      case MODE_INTERVAL:       engine2.handleInput(event, physicalKeyState); break;
+      case MODE_MIDI:           engine3.handleInput(event, physicalKeyState); break;
+    }
+    ledController.postInputEvent(event);
+  }
+
+  switch (currentMode) {
+    case MODE_PRESSURE_GLIDE:
+      keyboard.setAftertouchDeadzone(engine1.getAftertouchDeadzoneOffset());
+      break;
+    case MODE_INTERVAL:
+      // Share aftertouch parameters from Engine1
+      keyboard.setAftertouchDeadzone(engine1.getAftertouchDeadzoneOffset());
+      engine2.setSharedAftertouchParams(engine1.getAuxSmoothingTime());
+      break;
+    case MODE_MIDI:
+      engine3.setSharedAftertouchParams(engine1.getAuxSmoothingTime());
+      break;
+  }
+
+  loopProfiler.mark(LoopStage::INPUT_MANAGER);
+}
+
+void taskSensors() {
   keyboard.update();
+  if (keyboard.getKeyProcessingTicks()) loopProfiler.recordKeyProcessing(keyboard.getKeyProcessingTicks());
+
+  // Masques de la trame courante: vides si aucune trame capteur n'a été traitée ce tour-ci
+  uint32_t releases = keyboard.getReleaseMask();
+  uint32_t onsets = keyboard.getOnsetMask();
+  uint32_t pressureChanges = keyboard.getPressureChangedMask() & keyboard.getPressedMask();
 
-  if (events.mode_wasPressedLong) {
-    int nextModeIndex = ((int)currentMode + 1) % 3;
-    transitionToMode((GameMode)nextModeIndex);
+  // Flux MIDI sortant des modes clavier, note transposée comme le CV du moteur actif
+  if (currentMode != MODE_MIDI) {
+    uint32_t now = micros();
+    int octave = (currentMode == MODE_PRESSURE_GLIDE) ? engine1.getOctaveOffset() : engine2.getOctaveOffset();
+    uint32_t mask = releases;
+    while (mask) { int i = popLowestKey(mask); keyboardMidiOut.onKeyRelease(i, now); }
+    mask = onsets;
+    while (mask) { int i = popLowestKey(mask); keyboardMidiOut.onKeyPress(i, 36 + i + octave * 12, now); }
+    mask = pressureChanges;
+    while (mask) { int i = popLowestKey(mask); keyboardMidiOut.onPressure(i, keyboard.getPressure(i), now); }
+  }
+  keyboardMidiOut.update(micros());
+
+  switch (currentMode) {
+    case MODE_PRESSURE_GLIDE:
+      while (releases)        { int i = popLowestKey(releases);        engine1.onNoteOff(36 + i); }
+      while (onsets)          { int i = popLowestKey(onsets);          engine1.onNoteOn(36 + i, keyboard.getPressure(i), keyboard.getOnsetTimestamp(i)); }
+      while (pressureChanges) { int i = popLowestKey(pressureChanges); engine1.onAftertouchUpdate(i, keyboard.getPressure(i)); }
+      break;
+    case MODE_INTERVAL:
+      while (releases)        { int i = popLowestKey(releases);        engine2.onNoteOff(36 + i); }
+      while (onsets)          { int i = popLowestKey(onsets);          engine2.onNoteOn(36 + i, keyboard.getPressure(i), keyboard.getOnsetTimestamp(i)); }
+      while (pressureChanges) { int i = popLowestKey(pressureChanges); engine2.onAftertouchUpdate(i, keyboard.getPressure(i)); }
+      break;
+    case MODE_MIDI:
+      break;
   }
+  loopProfiler.mark(LoopStage::KEYBOARD);
+}
 
-  float pitchV, auxV;
+void taskEngine() {
+  uint16_t pitchCode;
+  float auxV;
   bool gateState, retrigger;
-  const bool* physicalKeyState = keyboard.getPressedKeysState();
+  uint32_t gateLength_us = 0;
+  unsigned long onsetTime_us = 0;
 
   switch (currentMode) {
-    case MODE_PRESSURE_GLIDE: {
-      engine1.processInputs(events, physicalKeyState);
-      keyboard.setAftertouchDeadzone(engine1.getAftertouchDeadzoneOffset());
-      for (int i = 0; i < NUM_KEYS; i++) {
-        uint8_t pitch = 36 + i;
-        if (keyboard.noteOn(i))  engine1.onNoteOn(pitch, keyboard.getPressure(i));
-        if (keyboard.noteOff(i)) engine1.onNoteOff(pitch);
-        if (keyboard.isPressed(i)) engine1.onAftertouchUpdate(i, keyboard.getPressure(i));
-      }
+    case MODE_PRESSURE_GLIDE:
       engine1.update();
-      pitchV = engine1.getPitchVoltage();
+      pitchCode = engine1.getPitchCode();
       auxV = engine1.getAuxVoltage();
       gateState = engine1.getGateState();
       retrigger = engine1.getAndClearRetriggerEvent();
+      onsetTime_us = engine1.getAndClearOutputOnset();
       break;
-    }
-    case MODE_INTERVAL: {
-      engine2.processInputs(events, physicalKeyState);
-      // Share aftertouch parameters from Engine1
-      keyboard.setAftertouchDeadzone(engine1.getAftertouchDeadzoneOffset());
-      engine2.setSharedAftertouchParams(engine1.getAuxSmoothingAlpha());
-      for (int i = 0; i < NUM_KEYS; i++) {
-        uint8_t pitch = 36 + i;
-        if (keyboard.noteOn(i))  engine2.onNoteOn(pitch, keyboard.getPressure(i));
-        if (keyboard.noteOff(i)) engine2.onNoteOff(pitch);
-        if (keyboard.isPressed(i)) engine2.onAftertouchUpdate(i, keyboard.getPressure(i));
-      }
+    case MODE_INTERVAL:
       engine2.update();
-      pitchV = engine2.getPitchVoltage();
+      pitchCode = engine2.getPitchCode();
       auxV = engine2.getAuxVoltage();
       gateState = engine2.getGateState();
+      gateLength_us = engine2.getGateLength_us();
+      for (uint8_t ticks = engine2.getAndClearClockOutTicks(); ticks > 0; ticks--) {
+        MIDI.sendRealTime(midi::Clock);
+        keyboardMidiOut.onRealTimeSent(1, micros());
+      }
       retrigger = engine2.getAndClearRetriggerEvent();
+      onsetTime_us = engine2.getAndClearOutputOnset();
       break;
-    }
-    case MODE_MIDI: {
-      engine3.processInputs(events, physicalKeyState);
+    case MODE_MIDI:
+    default:
       engine3.update();
-      pitchV = engine3.getPitchVoltage();
+      pitchCode = engine3.getPitchCode();
       auxV = engine3.getAuxVoltage();
       gateState = engine3.getGateState();
       retrigger = engine3.getAndClearRetriggerEvent();
+      onsetTime_us = engine3.getAndClearOutputOnset();
       break;
+  }
+  loopProfiler.mark(LoopStage::ENGINE);
+
+  renderAudioOutputs(pitchCode, auxV, gateState, gateLength_us, retrigger, onsetTime_us);
+  loopProfiler.mark(LoopStage::RENDER);
+}
+
+void taskLeds() {
+  // Le LedController vide sa file: tous les événements depuis la trame précédente
+  ledController.update(currentMode, engine1, engine2, engine3, keyboard);
+  loopProfiler.mark(LoopStage::LEDS);
+}
+
+// =================================================================
+// 6. LOOP PRINCIPALE
+// =================================================================
+void loop() {
+#if LOOP_PROFILER_ENABLED
+  // Commandes de débogage, hors tâches mesurées. Le port est partagé avec MIDI: le transport
+  // ne retient que les octets de commande arrivés entre deux messages, hors running status
+  if (pendingDebugCommand >= 0) {
+    int command = pendingDebugCommand;
+    pendingDebugCommand = -1;
+    loopProfiler.handleCommand(command);
+    scheduler.handleCommand(command);
+    if (command == LOOP_PROFILER_DUMP_COMMAND) {
+      Serial.print("MIDI entree: file max ");
+      Serial.print(midiTransport.getMaxDepth());
+      Serial.print("/");
+      Serial.print(MIDI_RX_RING_SIZE);
+      Serial.print(", debordements ");
+      Serial.println(midiTransport.getOverrunCount());
     }
   }
+#endif
 
-  // L'appel au LedController est maintenant à la fin pour lui donner le contexte final
-  ledController.update(currentMode, events, engine1, engine2, engine3, keyboard);
+  // Octets reçus vers la file MIDI, entre deux tâches
+  midiTransport.pump();
 
-  renderAudioOutputs(pitchV, auxV, gateState, retrigger);
-}
\ No newline at end of file
+  // Une "trame" du profileur = un passage de l'ordonnanceur qui a exécuté au moins une tâche
+  loopProfiler.beginFrame();
+  if (scheduler.run() > 0) {
+    loopProfiler.endFrame();
+  }
+}
@@ -3,6 +3,8 @@
 LedController::LedController() {
   _lastDisplayedOctave = -99;
   _lastDisplayedMode = (GameMode)-1;
+  _shiftModifiers = 0;
+  _potSensValue = 0;
 }
 
 void LedController::begin() {
@@ -10,10 +12,30 @@ void LedController::begin() {
 }
 
 // CORRECTION: La signature de la fonction correspond maintenant à celle du .h
-void LedController::update(GameMode mode, const InputEvents& events,
+void LedController::update(GameMode mode,
                            EngineMode1& engine1, EngineMode2& engine2, EngineMode3& engine3,
                            CapacitiveKeyboard& keyboard) 
 {
+  // --- ÉTAPE 0: VIDER LA FILE D'ÉVÉNEMENTS REÇUS DEPUIS LA TRAME PRÉCÉDENTE ---
+  bool modePressedShort = false;
+  bool potMoved = false;
+  bool encoderTurned = false;
+  InputEvent event;
+  while (_inputEvents.pop(event)) {
+    switch (event.type) {
+      case InputEventType::MODE_SHORT:       modePressedShort = true; break;
+      case InputEventType::POT_SENS:         potMoved = true; _potSensValue = event.value; break;
+      case InputEventType::ENCODER:          encoderTurned = true; break;
+      case InputEventType::SHIFT_PLUS_DOWN:  _shiftModifiers |= INPUT_MOD_SHIFT_PLUS; break;
+      case InputEventType::SHIFT_PLUS_UP:    _shiftModifiers &= ~INPUT_MOD_SHIFT_PLUS; break;
+      case InputEventType::SHIFT_MINUS_DOWN: _shiftModifiers |= INPUT_MOD_SHIFT_MINUS; break;
+      case InputEventType::SHIFT_MINUS_UP:   _shiftModifiers &= ~INPUT_MOD_SHIFT_MINUS; break;
+      default: break;
+    }
+  }
+  bool shiftPlus = _shiftModifiers & INPUT_MOD_SHIFT_PLUS;
+  bool shiftMinus = _shiftModifiers & INPUT_MOD_SHIFT_MINUS;
+
   // --- ÉTAPE 1: GESTION DES ÉVÉNEMENTS PRIORITAIRES (CHANGEMENT DE MODE) ---
   if (mode != _lastDisplayedMode) {
     switch(mode) {
@@ -21,27 +43,25 @@ void LedController::update(GameMode mode, const InputEvents& events,
       case MODE_INTERVAL:       _ledManager.playCrossfade(200, 3); break;
       case MODE_MIDI:           _ledManager.playInwardWipe(80, 2); break;
     }
+  } else if (modePressedShort && mode != MODE_MIDI) {
+    // Bascule de la sortie MIDI du clavier (aftertouch poly / MPE)
+    _ledManager.playValidation(180, 1);
   }
 
   // --- ÉTAPE 2: GESTION DES EFFETS D'AVANT-PLAN (INPUTS) ---
-  bool isInShiftMode = events.octPlus_isLongPressed || events.octMinus_isLongPressed;
+  bool isInShiftMode = shiftPlus || shiftMinus;
 
   if (isInShiftMode) {
-    if (events.octPlus_isLongPressed) {
+    if (shiftPlus) {
       int displayValue = 0;
       switch(mode) {
         case MODE_PRESSURE_GLIDE: {
-          // Show current smoothing value as inverted bargraph
-          // Non-linear mapping: expand low values (0.001-0.225) to 0-50%
-          // and compress high values (0.225-0.9) to 50-100%
-          float currentAlpha = engine1.getAuxSmoothingAlpha();
-          float normalizedAlpha = (currentAlpha - AUX_SMOOTHING_MIN_ALPHA) / 
-                                  (AUX_SMOOTHING_MAX_ALPHA - AUX_SMOOTHING_MIN_ALPHA);
-          
-          // Apply exponential curve to expand low range
-          // Use power of 0.4 to heavily favor the low end
-          float remappedValue = powf(normalizedAlpha, 0.4f);
-          displayValue = (int)(remappedValue * 100.0f);
+          // Show current smoothing time as inverted bargraph (full = fastest response)
+          // Log mapping: each encoder detent moves the bargraph by the same amount
+          float smoothingTime = engine1.getAuxSmoothingTime();
+          float position = logf(smoothingTime / AUX_SMOOTHING_MIN_TIME_MS) /
+                           logf(AUX_SMOOTHING_MAX_TIME_MS / AUX_SMOOTHING_MIN_TIME_MS);
+          displayValue = (int)((1.0f - position) * 100.0f + 0.5f);
           displayValue = constrain(displayValue, 0, 100);
           
           _ledManager.displayInvertedBargraph(displayValue);
@@ -59,7 +79,7 @@ void LedController::update(GameMode mode, const InputEvents& events,
           break;
       }
     } 
-    else if (events.octMinus_isLongPressed) {
+    else if (shiftMinus) {
       int displayValue = 0;
       switch(mode) {
         case MODE_PRESSURE_GLIDE: {
@@ -96,10 +116,10 @@ void LedController::update(GameMode mode, const InputEvents& events,
   } 
   // Sinon, on gère les bargraphs normaux
   else {
-    if (events.sens_potMoved) {
-      _ledManager.displayBargraph(map(events.potSensValue, 0, 1023, 0, 100));
+    if (potMoved) {
+      _ledManager.displayBargraph(map(_potSensValue, 0, 1023, 0, 100));
     }
-    if (events.live_encoderTurned) {
+    if (encoderTurned) {
       // Show current value based on mode: glide (mode1) or BPM (mode2)
       int displayValue = 0;
       switch(mode) {
@@ -18,12 +18,18 @@ public:
 
   void begin();
 
-  void update(GameMode mode, const InputEvents& events, 
+  // Appelé par la tâche d'entrée pour chaque événement; la trame LED suivante vide la file
+  void postInputEvent(const InputEvent& event) { _inputEvents.push(event); }
+
+  void update(GameMode mode,
               EngineMode1& engine1, EngineMode2& engine2, EngineMode3& engine3,
               CapacitiveKeyboard& keyboard);
 
 private:
   LedManager _ledManager; 
+  RingBuffer<InputEvent, INPUT_EVENT_QUEUE_SIZE> _inputEvents;
+  uint8_t _shiftModifiers;   // INPUT_MOD_* d'après les événements SHIFT reçus
+  int _potSensValue;
 
   int _lastDisplayedOctave;
   GameMode _lastDisplayedMode;
@@ -0,0 +1,115 @@
+#include "LoopProfiler.h"
+
+// Mode 2: le note on n'est rendu qu'au pas d'arpège suivant, la mesure est quantifiée au pas.
+// Mode 3: l'origine est la réception du message MIDI, pas une trame capteur.
+static const char* const MODE_NAMES[3] = {
+  "mode1", "mode2/pas", "mode3/midi"
+};
+
+static const char* const STAGE_NAMES[(uint8_t)LoopStage::COUNT] = {
+  "input", "keyboard", "engine", "leds", "render", "midi"
+};
+
+LoopProfiler::LoopProfiler() {
+  _frameStart = 0;
+  _lastMark = 0;
+}
+
+void LoopProfiler::begin() {
+#if LOOP_PROFILER_ENABLED
+  cycleCounterBegin();
+#endif
+  reset();
+}
+
+void LoopProfiler::reset() {
+  for (uint8_t i = 0; i < (uint8_t)LoopStage::COUNT; i++) {
+    _stages[i].reset();
+  }
+  _total.reset();
+  _perKey.reset();
+  for (uint8_t m = 0; m < 3; m++) {
+    _keyToOutput[m].reset();
+  }
+}
+
+bool LoopProfiler::handleCommand(int command) {
+  if (command == LOOP_PROFILER_DUMP_COMMAND) {
+    dump(Serial);
+    return true;
+  }
+  if (command == LOOP_PROFILER_RESET_COMMAND) {
+    reset();
+    return true;
+  }
+  return false;
+}
+
+float LoopProfiler::ticksToMicros(uint32_t ticks) const {
+  return (float)ticks * 1000000.0f / (float)cycleCounterHz();
+}
+
+void LoopProfiler::dump(Print& out) const {
+  out.print("--- Profil loop: ");
+  out.print(_total.count());
+  out.print(" trames, horloge ");
+  out.print(cycleCounterHz());
+  out.println(" Hz ---");
+  out.println("etage      n\tmin(us)\tp50(us)\tp99(us)\tmax(us)");
+  for (uint8_t i = 0; i < (uint8_t)LoopStage::COUNT; i++) {
+    dumpHistogram(out, STAGE_NAMES[i], _stages[i]);
+  }
+  dumpHistogram(out, "total", _total);
+
+  // En ticks bruts: des cycles CPU sur cible
+  out.println("--- Traitement par touche (ticks) ---");
+  out.println("           n\tmin\tp50\tp99\tmax");
+  dumpLatency(out, "touche", _perKey);
+
+  out.println("--- Latence touche -> sortie (mode2: attente du pas incluse) ---");
+  out.println("mode       n\tmin(us)\tp50(us)\tp99(us)\tmax(us)");
+  for (uint8_t m = 0; m < 3; m++) {
+    if (_keyToOutput[m].count() == 0) continue;
+    dumpLatency(out, MODE_NAMES[m], _keyToOutput[m]);
+  }
+}
+
+void LoopProfiler::dumpLatency(Print& out, const char* name, const Histogram& histogram) const {
+  out.print(name);
+  for (size_t pad = strlen(name); pad < 11; pad++) out.print(' ');
+  out.print(histogram.count());
+  out.print('\t');
+  out.print(histogram.minimum());
+  out.print('\t');
+  out.print(histogram.percentile(500));
+  out.print('\t');
+  out.print(histogram.percentile(990));
+  out.print('\t');
+  out.println(histogram.maximum());
+}
+
+void LoopProfiler::dumpHistogram(Print& out, const char* name, const Histogram& histogram) const {
+  out.print(name);
+  for (size_t pad = strlen(name); pad < 11; pad++) out.print(' ');
+  out.print(histogram.count());
+  out.print('\t');
+  out.print(ticksToMicros(histogram.minimum()));
+  out.print('\t');
+  out.print(ticksToMicros(histogram.percentile(500)));
+  out.print('\t');
+  out.print(ticksToMicros(histogram.percentile(990)));
+  out.print('\t');
+  out.println(ticksToMicros(histogram.maximum()));
+
+  // Cases non vides: borne haute (us) x nombre d'échantillons
+  out.print("  ");
+  for (uint8_t b = 0; b < Histogram::NUM_BUCKETS; b++) {
+    uint32_t n = histogram.bucketCount(b);
+    if (n == 0) continue;
+    out.print(ticksToMicros(Histogram::bucketUpperBound(b)));
+    out.print('x');
+    out.print(n);
+    out.print(' ');
+  }
+  out.println();
+}
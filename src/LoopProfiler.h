@@ -0,0 +1,100 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include "HardwareConfig.h"
+#include "CycleCounter.h"
+#include "Histogram.h"
+
+enum class LoopStage : uint8_t {
+  INPUT_MANAGER,
+  KEYBOARD,
+  ENGINE,
+  LEDS,
+  RENDER,
+  MIDI_INPUT,
+  COUNT
+};
+
+/**
+ * Temps passé dans chaque étage de loop(), en histogrammes de cycles.
+ *
+ * Usage: beginFrame() en tête de loop(), mark(étage) après chaque étage (le temps écoulé
+ * depuis le marqueur précédent est attribué à l'étage), endFrame() en fin de boucle.
+ * L'affichage (dump) est hors chemin critique: il n'est appelé que sur commande série.
+ */
+class LoopProfiler {
+public:
+  LoopProfiler();
+
+  void begin();
+
+  inline void beginFrame() {
+#if LOOP_PROFILER_ENABLED
+    _frameStart = cycleCounterNow();
+    _lastMark = _frameStart;
+#endif
+  }
+
+  inline void mark(LoopStage stage) {
+#if LOOP_PROFILER_ENABLED
+    uint32_t now = cycleCounterNow();
+    _stages[(uint8_t)stage].record(now - _lastMark);
+    _lastMark = now;
+#endif
+  }
+
+  inline void endFrame() {
+#if LOOP_PROFILER_ENABLED
+    _total.record(_lastMark - _frameStart);
+#endif
+  }
+
+  /**
+   * Latence touche -> sortie (µs): de l'échantillonnage de la trame qui a déclenché le Note On
+   * jusqu'à l'écriture du DAC et de PIN_GATE qui le rendent audible, par mode de jeu
+   */
+  inline void recordKeyToOutput(GameMode mode, uint32_t latency_us) {
+#if LOOP_PROFILER_ENABLED
+    _keyToOutput[mode].record(latency_us);
+#endif
+  }
+
+  /**
+   * Coût du traitement d'une touche (normalisation, chaîne de pression, publication), en ticks:
+   * CapacitiveKeyboard::getKeyProcessingTicks() après chaque trame capteur
+   */
+  inline void recordKeyProcessing(uint32_t ticksPerKey) {
+#if LOOP_PROFILER_ENABLED
+    _perKey.record(ticksPerKey);
+#endif
+  }
+
+  /**
+   * Traite une commande de débogage reçue sur le port série ('p' affiche, 'r' remet à zéro)
+   * @return true si l'octet était une commande du profileur
+   */
+  bool handleCommand(int command);
+
+  void reset();
+  void dump(Print& out) const;
+
+  const Histogram& getStageHistogram(LoopStage stage) const { return _stages[(uint8_t)stage]; }
+  const Histogram& getFrameHistogram() const { return _total; }
+  const Histogram& getKeyToOutputHistogram(GameMode mode) const { return _keyToOutput[mode]; }
+  const Histogram& getKeyProcessingHistogram() const { return _perKey; }
+
+private:
+  void dumpHistogram(Print& out, const char* name, const Histogram& histogram) const;
+  float ticksToMicros(uint32_t ticks) const;
+  void dumpLatency(Print& out, const char* name, const Histogram& histogram) const;
+
+  Histogram _stages[(uint8_t)LoopStage::COUNT];
+  Histogram _total;
+  Histogram _keyToOutput[3];  // Par GameMode, en µs
+  Histogram _perKey;          // Ticks par touche et par trame capteur
+  uint32_t _frameStart;
+  uint32_t _lastMark;
+};
+
+#endif // LOOP_PROFILER_H
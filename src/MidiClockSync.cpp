@@ -0,0 +1,91 @@
+#include "MidiClockSync.h"
+#include <math.h>
+
+MidiClockSync::MidiClockSync() {
+  _running = false;
+  _startCount = 0;
+  _tickCount = 0;
+  _lastTickPosition = -1;
+  _lastTick_us = 0;
+  _lastTickFrac = 0.0f;
+  _tickPeriod_us = 0.0f;
+  _lastRawTick_us = 0;
+  _ticksSinceLock = 0;
+}
+
+void MidiClockSync::resetLoop() {
+  _ticksSinceLock = 0;
+  _lastTickFrac = 0.0f;
+}
+
+void MidiClockSync::onClock(uint32_t now_us) {
+  if (_ticksSinceLock > 0 && (uint32_t)(now_us - _lastRawTick_us) >= MIDI_CLOCK_TIMEOUT_US) {
+    resetLoop();
+  }
+  _lastRawTick_us = now_us;
+
+  if (_ticksSinceLock == 0) {
+    _lastTick_us = now_us;
+    _lastTickFrac = 0.0f;
+  } else if (_ticksSinceLock == 1) {
+    // Premier intervalle: estimation brute de la période
+    _tickPeriod_us = (float)(uint32_t)(now_us - _lastTick_us) - _lastTickFrac;
+    _lastTick_us = now_us;
+    _lastTickFrac = 0.0f;
+  } else {
+    // Écart entre le tick reçu et sa date prédite (prédite = lissée précédente + période)
+    float predicted = _lastTickFrac + _tickPeriod_us;
+    float error = (float)(int32_t)(now_us - _lastTick_us) - predicted;
+    if (fabsf(error) > MIDI_CLOCK_MAX_ERROR_PERIODS * _tickPeriod_us) {
+      // Ticks perdus ou rafale: on se recale sur ce tick, la période estimée est conservée
+      _lastTick_us = now_us;
+      _lastTickFrac = 0.0f;
+      _ticksSinceLock = 1;
+    } else {
+      // Bande large à l'accrochage puis nominale: omega = max(1/n, bande)
+      float omega = 1.0f / _ticksSinceLock;
+      if (omega > 0.5f) omega = 0.5f;
+      if (omega < MIDI_CLOCK_DLL_BANDWIDTH) omega = MIDI_CLOCK_DLL_BANDWIDTH;
+      predicted += 1.41421356f * omega * error;
+      _tickPeriod_us += omega * omega * error;
+
+      // Renormalise: partie entière dans _lastTick_us, fraction dans [0, 1)
+      float whole = floorf(predicted);
+      _lastTick_us += (uint32_t)(int32_t)whole;
+      _lastTickFrac = predicted - whole;
+    }
+  }
+  if (_ticksSinceLock < 0xFFFF) _ticksSinceLock++;
+
+  // Un tick reçu à l'arrêt est le tick juste avant la position de reprise
+  if (_running) {
+    _lastTickPosition = _tickCount++;
+  } else {
+    _lastTickPosition = _tickCount - 1;
+  }
+}
+
+void MidiClockSync::onStart() {
+  _running = true;
+  _startCount++;
+  _tickCount = 0;
+  _lastTickPosition = -1;
+}
+
+void MidiClockSync::onContinue() {
+  _running = true;
+}
+
+void MidiClockSync::onStop() {
+  _running = false;
+}
+
+bool MidiClockSync::isLocked(uint32_t now_us) const {
+  return _ticksSinceLock >= 2 && _tickPeriod_us > 0.0f &&
+         (uint32_t)(now_us - _lastRawTick_us) < MIDI_CLOCK_TIMEOUT_US;
+}
+
+uint32_t MidiClockSync::predictTick_us(uint32_t position) const {
+  float offset = _lastTickFrac + (float)((int32_t)position - _lastTickPosition) * _tickPeriod_us;
+  return _lastTick_us + (uint32_t)(int32_t)lroundf(offset);
+}
@@ -0,0 +1,63 @@
+#ifndef MIDI_CLOCK_SYNC_H
+#define MIDI_CLOCK_SYNC_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+
+/**
+ * Réception de l'horloge MIDI (0xF8, 24 ppqn) et du transport (Start/Continue/Stop).
+ *
+ * - Chaque tick horodaté alimente une boucle à verrouillage de délai du second ordre: la date
+ *   lissée du tick et la période estimée suivent l'horloge externe, la gigue d'arrivée
+ *   (USB, polling du port) est filtrée au lieu d'être recopiée sur les pas de l'arpège
+ * - Bande passante large aux premiers ticks (accrochage rapide), puis MIDI_CLOCK_DLL_BANDWIDTH
+ * - Position: ticks reçus depuis Start, gelée sur Stop, reprise sur Continue. Les ticks reçus à
+ *   l'arrêt continuent d'alimenter l'estimateur et valent "le tick juste avant la reprise"
+ * - Plus de tick pendant MIDI_CLOCK_TIMEOUT_US: horloge perdue, le moteur repasse en interne
+ */
+class MidiClockSync {
+public:
+  MidiClockSync();
+
+  // --- Réception (appelée par les callbacks MIDI, now_us = instant de lecture) ---
+  void onClock(uint32_t now_us);
+  void onStart();
+  void onContinue();
+  void onStop();
+
+  /**
+   * @brief Horloge externe présente et période estimée (au moins deux ticks consécutifs).
+   */
+  bool isLocked(uint32_t now_us) const;
+  bool isRunning() const { return _running; }
+
+  // Incrémenté à chaque Start: le moteur repart du temps 0 quand il le voit changer
+  uint16_t getStartCount() const { return _startCount; }
+  // Position du prochain tick attendu (ticks depuis Start)
+  uint32_t getNextTickPosition() const { return (uint32_t)(_lastTickPosition + 1); }
+
+  float getTickPeriod_us() const { return _tickPeriod_us; }
+  float getTempo() const { return (_tickPeriod_us > 0.0f) ? 60000000.0f / (_tickPeriod_us * MIDI_CLOCKS_PER_BEAT) : 0.0f; }
+
+  /**
+   * @brief Date lissée (micros()) du tick de position donnée, passé ou à venir.
+   */
+  uint32_t predictTick_us(uint32_t position) const;
+
+private:
+  void resetLoop();
+
+  bool     _running;
+  uint16_t _startCount;
+  int32_t  _tickCount;          // Ticks reçus en marche depuis Start
+  int32_t  _lastTickPosition;   // Position du dernier tick reçu (-1 avant le premier)
+
+  // Boucle à verrouillage: date lissée du dernier tick = _lastTick_us + _lastTickFrac
+  uint32_t _lastTick_us;
+  float    _lastTickFrac;
+  float    _tickPeriod_us;      // 0 = inconnue
+  uint32_t _lastRawTick_us;
+  uint16_t _ticksSinceLock;
+};
+
+#endif // MIDI_CLOCK_SYNC_H
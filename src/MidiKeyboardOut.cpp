@@ -0,0 +1,280 @@
+#include "MidiKeyboardOut.h"
+#include "KeyboardData.h"
+#include <Arduino.h>
+
+static const uint8_t MIDI_NOTE_ON          = 0x90;
+static const uint8_t MIDI_POLY_PRESSURE    = 0xA0;
+static const uint8_t MIDI_CONTROL_CHANGE   = 0xB0;
+static const uint8_t MIDI_CHANNEL_PRESSURE = 0xD0;
+static const uint8_t MIDI_DATA_MAX         = 127;
+
+// RPN 6 (MPE Configuration Message) sur le canal maître
+static const uint8_t CC_RPN_MSB        = 101;
+static const uint8_t CC_RPN_LSB        = 100;
+static const uint8_t CC_DATA_ENTRY_MSB = 6;
+static const uint8_t RPN_MPE_CONFIG    = 6;
+static const uint8_t RPN_NULL          = 127;
+
+MidiKeyboardOut::MidiKeyboardOut() {
+  _send = nullptr;
+  _mode = MidiOutMode::POLY_AFTERTOUCH;
+  _lastStatus = 0;
+  _lineFree_us = 0;
+  _heldMask = 0;
+  _pendingMask = 0;
+  _nextKey = 0;
+  for (int i = 0; i < NUM_KEYS; i++) {
+    _note[i] = 0;
+    _channel[i] = MIDI_OUT_CHANNEL;
+    _sentPressure[i] = 0;
+    _pendingPressure[i] = 0;
+    _lastSent_us[i] = 0;
+  }
+  resetChannels();
+  _mergedCount = 0;
+  _droppedCount = 0;
+  _stolenCount = 0;
+  _maxBacklog_us = 0;
+  _messagesInWindow = 0;
+  _bytesInWindow = 0;
+  _messagesPerSecond = 0;
+  _bytesPerSecond = 0;
+  _statsWindowStart = 0;
+}
+
+void MidiKeyboardOut::begin(MidiOutSendFn send) {
+  _send = send;
+  _lastStatus = 0;
+  _lineFree_us = micros();
+  _statsWindowStart = millis();
+}
+
+void MidiKeyboardOut::setOutputMode(MidiOutMode mode, uint32_t now_us) {
+  if (mode == _mode) return;
+  releaseAll(now_us);
+  if (_mode == MidiOutMode::MPE_LOWER_ZONE) sendMpeConfiguration(0, now_us);
+  _mode = mode;
+  resetChannels();
+  if (_mode == MidiOutMode::MPE_LOWER_ZONE) sendMpeConfiguration(MPE_MEMBER_CHANNELS, now_us);
+}
+
+void MidiKeyboardOut::onKeyPress(uint8_t key, uint8_t note, uint32_t now_us) {
+  if (key >= NUM_KEYS) return;
+  uint32_t bit = 1UL << key;
+  if (_heldMask & bit) onKeyRelease(key, now_us);
+
+  uint8_t channel = MIDI_OUT_CHANNEL;
+  if (_mode == MidiOutMode::MPE_LOWER_ZONE) {
+    int8_t slot = allocateChannel(now_us);
+    _slotKey[slot] = key;
+    channel = MPE_MASTER_CHANNEL + 1 + slot;
+    // Le canal garde la pression de sa note précédente: remise à zéro avant le Note On
+    if (_slotPressure[slot] != 0) {
+      _slotPressure[slot] = 0;
+      sendMessage(MIDI_CHANNEL_PRESSURE, channel, 0, 0, now_us);
+    }
+  }
+
+  _note[key] = note & MIDI_DATA_MAX;
+  _channel[key] = channel;
+  _sentPressure[key] = 0;  // Pression implicite d'une note qui démarre
+  _lastSent_us[key] = now_us - MIDI_OUT_AT_MIN_INTERVAL_US;
+  _heldMask |= bit;
+  sendMessage(MIDI_NOTE_ON, channel, _note[key], MIDI_OUT_NOTE_VELOCITY, now_us);
+}
+
+void MidiKeyboardOut::onKeyRelease(uint8_t key, uint32_t now_us) {
+  if (key >= NUM_KEYS) return;
+  uint32_t bit = 1UL << key;
+  if (!(_heldMask & bit)) return;
+
+  if (_pendingMask & bit) {
+    _pendingMask &= ~bit;
+    _droppedCount++;
+  }
+  _heldMask &= ~bit;
+  // Vélocité nulle plutôt que 0x8n: le statut 0x9n reste courant
+  sendMessage(MIDI_NOTE_ON, _channel[key], _note[key], 0, now_us);
+
+  if (_mode == MidiOutMode::MPE_LOWER_ZONE) {
+    int8_t slot = (int8_t)(_channel[key] - MPE_MASTER_CHANNEL - 1);
+    listRemove(_busyChannels, slot);
+    listPushBack(_freeChannels, slot);
+  }
+}
+
+void MidiKeyboardOut::onPressure(uint8_t key, uint16_t pressure, uint32_t now_us) {
+  (void)now_us;
+  if (key >= NUM_KEYS) return;
+  uint32_t bit = 1UL << key;
+  if (!(_heldMask & bit)) return;
+
+  uint8_t value = (uint8_t)((pressure > CV_OUTPUT_RESOLUTION ? CV_OUTPUT_RESOLUTION : pressure) >> 5);
+  uint8_t sent = _sentPressure[key];
+  uint8_t diff = value > sent ? value - sent : sent - value;
+  // Les butées passent toujours: la valeur de repos arrive exacte même sous le seuil
+  bool significant = diff >= MIDI_OUT_AT_THRESHOLD ||
+                     (diff > 0 && (value == 0 || value == MIDI_DATA_MAX));
+
+  if (_pendingMask & bit) {
+    _mergedCount++;
+    if (!significant) {
+      _pendingMask &= ~bit;  // Revenue près de la valeur émise: plus rien à envoyer
+      return;
+    }
+  } else if (!significant) {
+    return;
+  }
+  _pendingPressure[key] = value;
+  _pendingMask |= bit;
+}
+
+void MidiKeyboardOut::onRealTimeSent(uint8_t count, uint32_t now_us) {
+  accountBytes(count, now_us);
+}
+
+void MidiKeyboardOut::update(uint32_t now_us) {
+  updateStats();
+  if (!_pendingMask) return;
+
+  // Touches à partir de _nextKey d'abord, puis les précédentes
+  uint32_t first = _pendingMask & ~((1UL << _nextKey) - 1);
+  uint32_t passes[2] = { first, _pendingMask & ~first };
+  for (uint8_t p = 0; p < 2; p++) {
+    while (passes[p]) {
+      int key = popLowestKey(passes[p]);
+      if ((uint32_t)(now_us - _lastSent_us[key]) < MIDI_OUT_AT_MIN_INTERVAL_US) continue;
+      if (backlog_us(now_us) > MIDI_OUT_MAX_BACKLOG_US) {
+        _nextKey = (uint8_t)key;
+        return;
+      }
+      uint8_t value = _pendingPressure[key];
+      _pendingMask &= ~(1UL << key);
+      _sentPressure[key] = value;
+      _lastSent_us[key] = now_us;
+      if (_mode == MidiOutMode::MPE_LOWER_ZONE) {
+        _slotPressure[_channel[key] - MPE_MASTER_CHANNEL - 1] = value;
+        sendMessage(MIDI_CHANNEL_PRESSURE, _channel[key], value, 0, now_us);
+      } else {
+        sendMessage(MIDI_POLY_PRESSURE, _channel[key], _note[key], value, now_us);
+      }
+      _nextKey = (key + 1 < NUM_KEYS) ? (uint8_t)(key + 1) : 0;
+    }
+  }
+}
+
+void MidiKeyboardOut::releaseAll(uint32_t now_us) {
+  uint32_t held = _heldMask;
+  while (held) {
+    onKeyRelease((uint8_t)popLowestKey(held), now_us);
+  }
+}
+
+// =================================================================
+// Canaux membres MPE
+// =================================================================
+void MidiKeyboardOut::resetChannels() {
+  // Ordre initial 2, 3, ... 16: tourniquet tant qu'aucun canal n'a été libéré
+  _freeChannels.head = _freeChannels.tail = NO_SLOT;
+  _busyChannels.head = _busyChannels.tail = NO_SLOT;
+  for (int8_t slot = 0; slot < (int8_t)MPE_MEMBER_CHANNELS; slot++) {
+    _slotKey[slot] = 0;
+    _slotPressure[slot] = UNKNOWN_PRESSURE;
+    listPushBack(_freeChannels, slot);
+  }
+}
+
+int8_t MidiKeyboardOut::allocateChannel(uint32_t now_us) {
+  if (_freeChannels.head == NO_SLOT) {
+    // Plus de canal libre: la note la plus ancienne est coupée, son canal revient en liste libre
+    _stolenCount++;
+    onKeyRelease(_slotKey[_busyChannels.head], now_us);
+  }
+  int8_t slot = _freeChannels.head;
+  listRemove(_freeChannels, slot);
+  listPushBack(_busyChannels, slot);
+  return slot;
+}
+
+void MidiKeyboardOut::listPushBack(ChannelList& list, int8_t slot) {
+  _slotPrev[slot] = list.tail;
+  _slotNext[slot] = NO_SLOT;
+  if (list.tail != NO_SLOT) _slotNext[list.tail] = slot;
+  else list.head = slot;
+  list.tail = slot;
+}
+
+void MidiKeyboardOut::listRemove(ChannelList& list, int8_t slot) {
+  int8_t prev = _slotPrev[slot];
+  int8_t next = _slotNext[slot];
+  if (prev != NO_SLOT) _slotNext[prev] = next;
+  else list.head = next;
+  if (next != NO_SLOT) _slotPrev[next] = prev;
+  else list.tail = prev;
+  _slotPrev[slot] = _slotNext[slot] = NO_SLOT;
+}
+
+void MidiKeyboardOut::sendMpeConfiguration(uint8_t memberChannels, uint32_t now_us) {
+  sendMessage(MIDI_CONTROL_CHANGE, MPE_MASTER_CHANNEL, CC_RPN_MSB, 0, now_us);
+  sendMessage(MIDI_CONTROL_CHANGE, MPE_MASTER_CHANNEL, CC_RPN_LSB, RPN_MPE_CONFIG, now_us);
+  sendMessage(MIDI_CONTROL_CHANGE, MPE_MASTER_CHANNEL, CC_DATA_ENTRY_MSB, memberChannels, now_us);
+  sendMessage(MIDI_CONTROL_CHANGE, MPE_MASTER_CHANNEL, CC_RPN_MSB, RPN_NULL, now_us);
+  sendMessage(MIDI_CONTROL_CHANGE, MPE_MASTER_CHANNEL, CC_RPN_LSB, RPN_NULL, now_us);
+}
+
+// =================================================================
+// Émission et budget de ligne
+// =================================================================
+void MidiKeyboardOut::sendMessage(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2,
+                                  uint32_t now_us) {
+  if (!_send) return;
+  uint8_t status = type | ((channel - 1) & 0x0F);
+  uint8_t bytes = (type == MIDI_CHANNEL_PRESSURE) ? 1 : 2;
+  if (status != _lastStatus) bytes++;
+  _lastStatus = status;
+  _send(type, channel, data1, data2);
+  _messagesInWindow++;
+  accountBytes(bytes, now_us);
+}
+
+void MidiKeyboardOut::accountBytes(uint8_t count, uint32_t now_us) {
+  // Ligne inactive: l'émission repart de maintenant
+  if ((int32_t)(now_us - _lineFree_us) > 0) _lineFree_us = now_us;
+  _lineFree_us += count * MIDI_OUT_BYTE_TIME_US;
+  _bytesInWindow += count;
+  uint32_t backlog = _lineFree_us - now_us;
+  if (backlog > _maxBacklog_us) _maxBacklog_us = backlog;
+}
+
+uint32_t MidiKeyboardOut::backlog_us(uint32_t now_us) const {
+  int32_t backlog = (int32_t)(_lineFree_us - now_us);
+  return backlog > 0 ? (uint32_t)backlog : 0;
+}
+
+void MidiKeyboardOut::updateStats() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - _statsWindowStart;
+  if (elapsed < MIDI_OUT_STATS_WINDOW_MS) return;
+
+  _messagesPerSecond = (uint32_t)(((uint64_t)_messagesInWindow * 1000UL) / elapsed);
+  _bytesPerSecond = (uint32_t)(((uint64_t)_bytesInWindow * 1000UL) / elapsed);
+  _messagesInWindow = 0;
+  _bytesInWindow = 0;
+  _statsWindowStart = now;
+
+  #if DEBUG_LEVEL >= 3
+  Serial.print("[MIDI] Sortie: ");
+  Serial.print(_messagesPerSecond);
+  Serial.print(" msg/s, ");
+  Serial.print(_bytesPerSecond);
+  Serial.print(" octets/s, fusionnes ");
+  Serial.print(_mergedCount);
+  Serial.print(", perdus ");
+  Serial.print(_droppedCount);
+  Serial.print(", voles ");
+  Serial.print(_stolenCount);
+  Serial.print(", retard max ");
+  Serial.print(_maxBacklog_us);
+  Serial.println(" us");
+  #endif
+}
@@ -0,0 +1,125 @@
+#ifndef MIDI_KEYBOARD_OUT_H
+#define MIDI_KEYBOARD_OUT_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+
+// Émission d'un message de canal: type sans canal (0x90, 0xA0...), canal 1-16, données
+typedef void (*MidiOutSendFn)(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2);
+
+enum class MidiOutMode : uint8_t {
+  POLY_AFTERTOUCH,  // Un canal, aftertouch polyphonique
+  MPE_LOWER_ZONE    // Un canal membre par note, pression en Channel Pressure
+};
+
+/**
+ * Flux MIDI sortant du clavier capacitif: notes et pression par note.
+ *
+ * - Note off = Note On vélocité 0: tout le flux garde le statut 0x9n, seule la pression
+ *   le change. Le running status de l'émetteur est suivi pour compter les octets réels
+ * - Pression: seuil par touche (écart au dernier envoyé), intervalle minimal par touche, et
+ *   budget de ligne: la date de fin d'émission des octets déjà partis est estimée; tant qu'elle
+ *   dépasse MIDI_OUT_MAX_BACKLOG_US, la pression attend. Notes et horloge passent toujours
+ * - Une valeur en attente remplacée par une plus récente est "fusionnée"; une valeur en attente
+ *   abandonnée au relâchement de la touche est "perdue"
+ * - update() parcourt les touches en attente à partir d'une position tournante: aucune touche
+ *   ne monopolise le budget
+ * - MPE: canaux membres en deux listes chaînées (libres par ordre de libération, occupés par
+ *   ordre d'attribution): attribution, libération et vol de canal en O(1)
+ */
+class MidiKeyboardOut {
+public:
+  MidiKeyboardOut();
+
+  void begin(MidiOutSendFn send);
+
+  /**
+   * @brief Change de mode de sortie: notes tenues closes, configuration MPE (RPN 6) envoyée
+   * sur le canal maître en entrant en MPE, annulée en sortant.
+   */
+  void setOutputMode(MidiOutMode mode, uint32_t now_us);
+  MidiOutMode getOutputMode() const { return _mode; }
+
+  // Événements clavier (note = numéro MIDI déjà transposé, pression 0..4095)
+  void onKeyPress(uint8_t key, uint8_t note, uint32_t now_us);
+  void onKeyRelease(uint8_t key, uint32_t now_us);
+  void onPressure(uint8_t key, uint16_t pressure, uint32_t now_us);
+
+  // Octets temps réel émis par ailleurs sur la même ligne (horloge): comptés dans le budget
+  void onRealTimeSent(uint8_t count, uint32_t now_us);
+
+  /**
+   * @brief Émet les pressions en attente dont l'intervalle est écoulé, dans le budget de ligne.
+   */
+  void update(uint32_t now_us);
+
+  /**
+   * @brief Note off de toutes les touches tenues (sortie des modes clavier).
+   */
+  void releaseAll(uint32_t now_us);
+
+  // Totaux depuis le démarrage
+  uint32_t getMergedCount() const { return _mergedCount; }
+  uint32_t getDroppedCount() const { return _droppedCount; }
+  uint32_t getStolenCount() const { return _stolenCount; }
+  uint32_t getMaxBacklog_us() const { return _maxBacklog_us; }
+
+  // Compteurs sur MIDI_OUT_STATS_WINDOW_MS, ramenés à la seconde
+  uint32_t getMessagesPerSecond() const { return _messagesPerSecond; }
+  uint32_t getBytesPerSecond() const { return _bytesPerSecond; }
+
+private:
+  static const int8_t  NO_SLOT = -1;
+  static const uint8_t UNKNOWN_PRESSURE = 0xFF;  // État du récepteur inconnu: à remettre à 0
+
+  // Liste doublement chaînée de canaux membres (index 0 = canal 2)
+  struct ChannelList {
+    int8_t head;
+    int8_t tail;
+  };
+
+  void resetChannels();
+  int8_t allocateChannel(uint32_t now_us);
+  void listPushBack(ChannelList& list, int8_t slot);
+  void listRemove(ChannelList& list, int8_t slot);
+  void sendMpeConfiguration(uint8_t memberChannels, uint32_t now_us);
+
+  void sendMessage(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2, uint32_t now_us);
+  void accountBytes(uint8_t count, uint32_t now_us);
+  uint32_t backlog_us(uint32_t now_us) const;
+  void updateStats();
+
+  MidiOutSendFn _send;
+  MidiOutMode _mode;
+  uint8_t  _lastStatus;              // Running status de l'émetteur (0 = aucun)
+  uint32_t _lineFree_us;             // Fin estimée de l'émission des octets déjà envoyés
+
+  uint32_t _heldMask;                // Touches dont la note sonne côté récepteur
+  uint32_t _pendingMask;
+  uint8_t  _nextKey;                 // Départ tournant du parcours des pressions en attente
+  uint8_t  _note[NUM_KEYS];
+  uint8_t  _channel[NUM_KEYS];       // Canal de la note (1-16)
+  uint8_t  _sentPressure[NUM_KEYS];  // Dernière pression émise
+  uint8_t  _pendingPressure[NUM_KEYS];
+  uint32_t _lastSent_us[NUM_KEYS];
+
+  // Canaux membres MPE
+  ChannelList _freeChannels;         // Tête = libéré le moins récemment
+  ChannelList _busyChannels;         // Tête = attribué le plus anciennement
+  int8_t  _slotPrev[MPE_MEMBER_CHANNELS];
+  int8_t  _slotNext[MPE_MEMBER_CHANNELS];
+  uint8_t _slotKey[MPE_MEMBER_CHANNELS];
+  uint8_t _slotPressure[MPE_MEMBER_CHANNELS];  // Dernière Channel Pressure émise sur le canal
+
+  uint32_t _mergedCount;
+  uint32_t _droppedCount;
+  uint32_t _stolenCount;
+  uint32_t _maxBacklog_us;
+  uint32_t _messagesInWindow;
+  uint32_t _bytesInWindow;
+  uint32_t _messagesPerSecond;
+  uint32_t _bytesPerSecond;
+  unsigned long _statsWindowStart;
+};
+
+#endif // MIDI_KEYBOARD_OUT_H
@@ -0,0 +1,63 @@
+#include "MidiRxTransport.h"
+
+static const uint8_t MIDI_STATUS_SYSEX     = 0xF0;
+static const uint8_t MIDI_STATUS_REALTIME  = 0xF8;
+
+MidiRxTransport::MidiRxTransport(HardwareSerial& port) : _port(port) {
+  _commandHandler = nullptr;
+  _runningLength = 0;
+  _expected = 0;
+  _inSysEx = false;
+}
+
+void MidiRxTransport::begin() {
+  _port.begin(31250);
+}
+
+void MidiRxTransport::pump() {
+  while (_port.available() > 0) {
+    _ring.push((uint8_t)_port.read());
+  }
+}
+
+unsigned MidiRxTransport::available() {
+  // Octets de commande en tête de file, entre deux messages et hors running status: retirés
+  // avant l'analyseur. Sous running status, un octet de données ouvre le message suivant
+  uint8_t byte;
+  while (_commandHandler && _ring.peek(byte) && byte < 0x80 && _expected == 0 && _runningLength == 0 &&
+         !_inSysEx) {
+    if (!_commandHandler(byte)) break;
+    _ring.pop(byte);
+  }
+  return _ring.size();
+}
+
+uint8_t MidiRxTransport::read() {
+  uint8_t byte = 0;
+  if (!_ring.pop(byte)) return 0;
+
+  if (byte >= MIDI_STATUS_REALTIME) {
+    // Temps réel: s'intercale sans toucher au message en cours
+  } else if (byte & 0x80) {
+    _inSysEx = (byte == MIDI_STATUS_SYSEX);
+    _expected = dataLength(byte);
+    // Seuls les messages de canal ouvrent un running status
+    _runningLength = (byte < MIDI_STATUS_SYSEX) ? _expected : 0;
+  } else if (!_inSysEx) {
+    if (_expected == 0) _expected = _runningLength;
+    if (_expected > 0) _expected--;
+  }
+  return byte;
+}
+
+uint8_t MidiRxTransport::dataLength(uint8_t status) {
+  switch (status & 0xF0) {
+    case midi::ProgramChange:
+    case midi::AfterTouchChannel: return 1;
+    case 0xF0:
+      if (status == midi::SongPosition) return 2;
+      if (status == midi::TimeCodeQuarterFrame || status == midi::SongSelect) return 1;
+      return 0;
+    default: return 2;
+  }
+}
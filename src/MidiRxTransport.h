@@ -0,0 +1,64 @@
+#ifndef MIDI_RX_TRANSPORT_H
+#define MIDI_RX_TRANSPORT_H
+
+#include <Arduino.h>
+#include <MIDI.h>
+#include "HardwareConfig.h"
+#include "RingBuffer.h"
+
+// Octet hors message MIDI (commande de débogage tapée sur le port): true s'il a été consommé
+typedef bool (*MidiCommandHandler)(uint8_t byte);
+
+/**
+ * Transport série de la MIDI Library avec une file d'octets entre le port et l'analyseur.
+ *
+ * - Producteur: pump(), appelé par loop() à chaque passage (jamais sous interruption: Serial
+ *   est le port USB CDC, dont l'API n'est pas réentrante), vide le tampon de réception du cœur
+ *   dans une RingBuffer. Un octet attend au plus un passage de l'ordonnanceur, soit la plus
+ *   longue tâche, avant d'entrer en file
+ * - Consommateur: la MIDI Library (réglage Use1ByteParsing) via available()/read(), un octet
+ *   par MIDI.read(): la tâche MIDI borne le nombre d'octets analysés par tick
+ * - File pleine: l'octet est perdu et compté (débordement); l'occupation maximale est suivie
+ * - Un octet de données qui arrive entre deux messages, hors running status, est d'abord
+ *   proposé au gestionnaire de commandes. Sous running status (après tout message de canal,
+ *   jusqu'au prochain message système), c'est la première donnée du message suivant: une
+ *   valeur 0x70 ou 0x72 reste une note, un bend ou une pression, jamais 'p' ou 'r'
+ */
+class MidiRxTransport {
+public:
+  static const bool thruActivated = false;
+
+  explicit MidiRxTransport(HardwareSerial& port);
+
+  void setCommandHandler(MidiCommandHandler handler) { _commandHandler = handler; }
+
+  // Transfère les octets reçus par le port (contexte principal uniquement)
+  void pump();
+
+  // --- Interface transport de la MIDI Library ---
+  void begin();
+  bool beginTransmission(midi::MidiType) { return true; }
+  void write(uint8_t byte) { _port.write(byte); }
+  void endTransmission() {}
+  unsigned available();
+  uint8_t read();
+
+  // Compteurs depuis le démarrage
+  uint32_t getOverrunCount() const { return _ring.getDroppedCount(); }
+  uint16_t getMaxDepth() const { return _ring.getMaxSize(); }
+  uint16_t getDepth() const { return _ring.size(); }
+
+private:
+  static uint8_t dataLength(uint8_t status);
+
+  HardwareSerial& _port;
+  RingBuffer<uint8_t, MIDI_RX_RING_SIZE> _ring;
+  MidiCommandHandler _commandHandler;
+
+  // Suivi minimal du flux, pour reconnaître les octets hors message
+  uint8_t _runningLength;  // Octets de données d'un message en running status (0: aucun)
+  uint8_t _expected;       // Octets de données encore attendus par le message en cours
+  bool    _inSysEx;
+};
+
+#endif // MIDI_RX_TRANSPORT_H
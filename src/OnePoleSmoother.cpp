@@ -0,0 +1,42 @@
+#include "OnePoleSmoother.h"
+#include <math.h>
+
+// exp(-x) pour x = 0..ONE_POLE_LUT_RANGE, partagée par toutes les instances
+static float decayTable[ONE_POLE_LUT_SIZE + 1];
+static bool decayTableReady = false;
+
+void OnePoleSmoother::buildDecayTable() {
+  for (int k = 0; k <= ONE_POLE_LUT_SIZE; k++) {
+    decayTable[k] = expf(-ONE_POLE_LUT_RANGE * (float)k / (float)ONE_POLE_LUT_SIZE);
+  }
+  decayTableReady = true;
+}
+
+OnePoleSmoother::OnePoleSmoother() {
+  if (!decayTableReady) buildDecayTable();
+  _value = 0.0f;
+  _tau_ms = 0.0f;
+  _lutPerMicro = 0.0f;
+}
+
+void OnePoleSmoother::setTimeConstant(float tau_ms) {
+  _tau_ms = (tau_ms > 0.0f) ? tau_ms : 0.0f;
+  _lutPerMicro = (_tau_ms > 0.0f) ? (float)ONE_POLE_LUT_SIZE / (ONE_POLE_LUT_RANGE * _tau_ms * 1000.0f) : 0.0f;
+}
+
+float OnePoleSmoother::alpha(uint32_t dt_us) const {
+  if (_tau_ms <= 0.0f) return 1.0f;
+  float pos = (float)dt_us * _lutPerMicro;
+  // Au-delà de la table, exp(-x) < exp(-RANGE): la cible est considérée atteinte
+  if (pos >= (float)ONE_POLE_LUT_SIZE) return 1.0f;
+  // Premier segment (dt << tau, cas courant d'un tick moteur): l'interpolation y perdrait ~2 %
+  // sur alpha, le développement limité x - x²/2 est exact à x²/6 près
+  if (pos < 1.0f) {
+    float x = pos * (ONE_POLE_LUT_RANGE / ONE_POLE_LUT_SIZE);
+    return x - 0.5f * x * x;
+  }
+  int idx = (int)pos;
+  float frac = pos - (float)idx;
+  float decay = decayTable[idx] + (decayTable[idx + 1] - decayTable[idx]) * frac;
+  return 1.0f - decay;
+}
@@ -0,0 +1,46 @@
+#ifndef ONE_POLE_SMOOTHER_H
+#define ONE_POLE_SMOOTHER_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+
+/**
+ * Passe-bas à un pôle paramétré par sa constante de temps en millisecondes.
+ *
+ * - Le coefficient alpha = 1 - exp(-dt/tau) est recalculé à chaque appel à partir du temps
+ *   réellement écoulé: la réponse ne dépend pas de la cadence d'appel
+ * - exp(-x) est lu dans une table partagée (interpolation linéaire), jamais expf en jeu
+ * - tau = 0: pas de lissage, la sortie suit la cible
+ */
+class OnePoleSmoother {
+public:
+  OnePoleSmoother();
+
+  void  setTimeConstant(float tau_ms);
+  float getTimeConstant() const { return _tau_ms; }
+
+  void  reset(float value) { _value = value; }
+  float value() const { return _value; }
+
+  /**
+   * @brief Avance le filtre de dt_us vers target et renvoie la nouvelle sortie.
+   */
+  float process(float target, uint32_t dt_us) {
+    _value += alpha(dt_us) * (target - _value);
+    return _value;
+  }
+
+  /**
+   * @brief Coefficient à appliquer pour un pas de dt_us (0 = figé, 1 = cible atteinte).
+   */
+  float alpha(uint32_t dt_us) const;
+
+private:
+  static void buildDecayTable();
+
+  float _value;
+  float _tau_ms;
+  float _lutPerMicro;  // Index de table (virgule flottante) par µs écoulée: LUT_SIZE / (RANGE x tau)
+};
+
+#endif // ONE_POLE_SMOOTHER_H
@@ -0,0 +1,73 @@
+#include "PitchCalibration.h"
+#include <Arduino.h>
+#include <EEPROM.h>
+
+PitchCalibration::PitchCalibration() {
+  resetToIdeal();
+  rebuildTable();
+}
+
+bool PitchCalibration::begin() {
+  PitchCalStore data;
+  EEPROM.get(EEPROM_PITCH_CAL_ADDR, data);
+  bool valid = (data.magic == PITCH_CAL_MAGIC && data.version == PITCH_CAL_VERSION);
+  if (valid) {
+    for (uint8_t i = 0; i < PITCH_CAL_NUM_POINTS; i++) {
+      setOctaveCode(i, data.octaveCode[i]);
+    }
+  } else {
+    resetToIdeal();
+  }
+  rebuildTable();
+
+  #if DEBUG_LEVEL >= 0
+  Serial.println(valid ? "INFO: Calibration 1V/oct chargee." : "INFO: Pas de calibration 1V/oct, DAC suppose ideal.");
+  #endif
+  return valid;
+}
+
+void PitchCalibration::save() const {
+  PitchCalStore data;
+  data.magic = PITCH_CAL_MAGIC;
+  data.version = PITCH_CAL_VERSION;
+  data.reserved = 0;
+  memcpy(data.octaveCode, _octaveCode, sizeof(_octaveCode));
+  EEPROM.put(EEPROM_PITCH_CAL_ADDR, data);
+}
+
+void PitchCalibration::setOctaveCode(uint8_t point, uint16_t code) {
+  if (point >= PITCH_CAL_NUM_POINTS) return;
+  _octaveCode[point] = (code > CV_OUTPUT_RESOLUTION) ? CV_OUTPUT_RESOLUTION : code;
+}
+
+uint16_t PitchCalibration::getOctaveCode(uint8_t point) const {
+  return (point < PITCH_CAL_NUM_POINTS) ? _octaveCode[point] : 0;
+}
+
+uint16_t PitchCalibration::idealOctaveCode(uint8_t point) {
+  float code = point * PITCH_STANDARD_VOLTS_PER_OCTAVE * DAC_DEFAULT_CODES_PER_VOLT + 0.5f;
+  return (code > CV_OUTPUT_RESOLUTION) ? CV_OUTPUT_RESOLUTION : (uint16_t)code;
+}
+
+void PitchCalibration::resetToIdeal() {
+  for (uint8_t i = 0; i < PITCH_CAL_NUM_POINTS; i++) {
+    _octaveCode[i] = idealOctaveCode(i);
+  }
+}
+
+void PitchCalibration::rebuildTable() {
+  for (int semitone = 0; semitone < TABLE_SIZE; semitone++) {
+    int octave = semitone / 12;
+    int step = semitone % 12;
+    if (step == 0) {
+      _table[semitone] = _octaveCode[octave];
+      continue;
+    }
+    // Interpolation entière arrondie entre les deux points encadrants (pente éventuellement négative)
+    int32_t low = _octaveCode[octave];
+    int32_t span = (int32_t)_octaveCode[octave + 1] - low;
+    int32_t scaled = span * step;
+    scaled += (scaled >= 0) ? 6 : -6;
+    _table[semitone] = (uint16_t)(low + scaled / 12);
+  }
+}
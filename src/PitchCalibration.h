@@ -0,0 +1,54 @@
+#ifndef PITCH_CALIBRATION_H
+#define PITCH_CALIBRATION_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+#include "KeyboardData.h"
+
+/**
+ * Table note -> code DAC de la sortie Pitch (1V/oct), corrigée par octave.
+ *
+ * - PITCH_CAL_NUM_POINTS points mesurés (code DAC réellement à 0V, 1V ... 10V), en EEPROM
+ * - Entre deux points, les 12 demi-tons sont interpolés linéairement à la construction
+ * - En jeu: une seule lecture de table par changement de note, sans flottant
+ */
+class PitchCalibration {
+public:
+  // Demi-tons couverts par la plage 0-10V
+  static const int TABLE_SIZE = (PITCH_CAL_NUM_POINTS - 1) * 12 + 1;
+
+  PitchCalibration();
+
+  /**
+   * @brief Charge les points depuis l'EEPROM (points idéaux si absents) et construit la table.
+   * @return true si une calibration valide a été trouvée.
+   */
+  bool begin();
+  void save() const;
+
+  // Points de correction; rebuildTable() doit être appelé après modification
+  void     setOctaveCode(uint8_t point, uint16_t code);
+  uint16_t getOctaveCode(uint8_t point) const;
+  static uint16_t idealOctaveCode(uint8_t point);
+  void     resetToIdeal();
+  void     rebuildTable();
+
+  /**
+   * @brief Code DAC d'une note MIDI (octave déjà appliquée), saturé à la plage 0-10V.
+   * PITCH_REFERENCE_MIDI_NOTE sort à PITCH_CV_CENTER_VOLTAGE.
+   */
+  uint16_t noteToCode(int note) const {
+    int index = note - PITCH_REFERENCE_MIDI_NOTE + CENTER_INDEX;
+    if (index < 0) index = 0;
+    if (index >= TABLE_SIZE) index = TABLE_SIZE - 1;
+    return _table[index];
+  }
+
+private:
+  static const int CENTER_INDEX = (int)(PITCH_CV_CENTER_VOLTAGE * 12.0f + 0.5f);
+
+  uint16_t _octaveCode[PITCH_CAL_NUM_POINTS];
+  uint16_t _table[TABLE_SIZE];
+};
+
+#endif // PITCH_CALIBRATION_H
@@ -0,0 +1,101 @@
+#include "PressureChain.h"
+#include <Arduino.h>
+#include <math.h>
+
+#define Q15_ONE 32768
+
+float evaluateResponseCurve(float x, float shape, float expIntensity, uint8_t sigIntensity) {
+  float shaped_norm;
+  if (shape < 0.5f) {
+    float y_exp = powf(x, expIntensity);
+    float t = 1.0f - (shape * 2.0f);
+    shaped_norm = x * (1.0f - t) + y_exp * t;
+  } else {
+    float y_sig = x * x * (3.0f - 2.0f * x);
+    for (int j = 1; j < sigIntensity; j++) {
+        y_sig = y_sig * y_sig * (3.0f - 2.0f * y_sig);
+    }
+    float t = (shape - 0.5f) * 2.0f;
+    shaped_norm = x * (1.0f - t) + y_sig * t;
+  }
+  return constrain(shaped_norm, 0.0f, 1.0f);
+}
+
+void buildResponseCurve(uint16_t* curve, float shape, float expIntensity, uint8_t sigIntensity) {
+  for (int k = 0; k <= RESPONSE_CURVE_LUT_SIZE; k++) {
+    float x = (float)k / (float)RESPONSE_CURVE_LUT_SIZE;
+    curve[k] = (uint16_t)(evaluateResponseCurve(x, shape, expIntensity, sigIntensity) * 32768.0f + 0.5f);
+  }
+}
+
+// =================================================================
+// Chaîne de pression en virgule fixe
+// =================================================================
+// x normalisé et courbe en Q15 (32768 = 1.0), pressions en Q4 sur l'échelle 0..CV_OUTPUT_RESOLUTION.
+// Aucune opération flottante par touche: une division entière pour la normalisation, puis table + shifts.
+uint16_t PressureChainFixed::process(bool pressed, uint16_t delta, uint16_t pressDelta, uint16_t maxDelta,
+                                     const uint16_t* curve) {
+  // --- Calcul de la pression si la touche est active ---
+  int32_t targetPressure = 0;
+  if (pressed) {
+    int32_t x = 0;
+    if (maxDelta > pressDelta && delta > pressDelta) {
+      x = ((int32_t)(delta - pressDelta) << 15) / (int32_t)(maxDelta - pressDelta);
+      if (x > Q15_ONE) x = Q15_ONE;
+    }
+
+    int32_t shaped = lookupResponseCurve(curve, x);
+    targetPressure = (int32_t)(((uint32_t)shaped * (CV_OUTPUT_RESOLUTION << PRESSURE_FRAC_BITS)) >> 15);
+  }
+
+  // --- Lissage ETAGE 1: Slew Limiter ---
+  const int32_t slewLimit = AFTERTOUCH_SLEW_RATE_LIMIT << PRESSURE_FRAC_BITS;
+  int32_t diff = targetPressure - _slewed;
+  if (diff > slewLimit) {
+    _slewed += slewLimit;
+  } else if (diff < -slewLimit) {
+    _slewed -= slewLimit;
+  } else {
+    _slewed = targetPressure;
+  }
+
+  // --- Lissage ETAGE 2: Moyenne Mobile ---
+  _smoothed = _average.push((uint16_t)_slewed) >> PRESSURE_FRAC_BITS;
+  return _smoothed;
+}
+
+// =================================================================
+// Chaîne de pression flottante (référence)
+// =================================================================
+uint16_t PressureChainFloat::process(bool pressed, uint16_t delta, uint16_t pressDelta, uint16_t maxDelta,
+                                     const uint16_t* curve) {
+  // --- Calcul de la pression si la touche est active ---
+  float targetPressure = 0.0f;
+  if (pressed) {
+    // La plage de pression utile va du delta de départ au delta max calibré
+    float aftertouch_norm = 0.0f;
+    if (maxDelta > pressDelta) {
+      // Calcul de la pression normalisée à partir du "Zéro Relatif"
+      aftertouch_norm = (float)((delta > pressDelta) ? (delta - pressDelta) : 0) / (float)(maxDelta - pressDelta);
+    }
+    if (aftertouch_norm > 1.0f) aftertouch_norm = 1.0f;
+
+    float shaped_norm = lookupResponseCurve(curve, (int32_t)(aftertouch_norm * 32768.0f)) / 32768.0f;
+    targetPressure = shaped_norm * (float)CV_OUTPUT_RESOLUTION;
+  }
+
+  // --- Lissage ETAGE 1: Slew Limiter ---
+  float diff = targetPressure - _slewed;
+  if (diff > AFTERTOUCH_SLEW_RATE_LIMIT) {
+    _slewed += AFTERTOUCH_SLEW_RATE_LIMIT;
+  } else if (diff < -AFTERTOUCH_SLEW_RATE_LIMIT) {
+    _slewed -= AFTERTOUCH_SLEW_RATE_LIMIT;
+  } else {
+    _slewed = targetPressure;
+  }
+
+  // --- Lissage ETAGE 2: Moyenne Mobile (historique entier en Q4) ---
+  uint16_t slewedQ4 = (uint16_t)(_slewed * (1 << PRESSURE_FRAC_BITS) + 0.5f);
+  _smoothed = _average.push(slewedQ4) / (float)(1 << PRESSURE_FRAC_BITS);
+  return (uint16_t)_smoothed;
+}
@@ -0,0 +1,89 @@
+#ifndef PRESSURE_CHAIN_H
+#define PRESSURE_CHAIN_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+#include "RunningAverage.h"
+
+// Bits fractionnaires des pressions stockées en entier (échelle 0..CV_OUTPUT_RESOLUTION)
+#define PRESSURE_FRAC_BITS 4
+
+/**
+ * Courbe de réponse paramétrique: mélange linéaire/exponentielle (shape < 0.5) ou
+ * linéaire/sigmoïde (shape >= 0.5), x et résultat dans 0..1. Hors chemin critique (powf).
+ */
+float evaluateResponseCurve(float x, float shape, float expIntensity, uint8_t sigIntensity);
+
+/**
+ * Remplit une table Q15 (32768 = 1.0) de RESPONSE_CURVE_LUT_SIZE + 1 points avec la courbe.
+ */
+void buildResponseCurve(uint16_t* curve, float shape, float expIntensity, uint8_t sigIntensity);
+
+/**
+ * Lecture de la table avec interpolation linéaire entre deux points, x et résultat en Q15.
+ */
+inline int32_t lookupResponseCurve(const uint16_t* curve, int32_t xQ15) {
+  const int shift = 15 - RESPONSE_CURVE_LUT_BITS;
+  if (xQ15 >= 32768) return curve[RESPONSE_CURVE_LUT_SIZE];
+  if (xQ15 <= 0) return curve[0];
+  int32_t idx = xQ15 >> shift;
+  int32_t frac = xQ15 & ((1 << shift) - 1);
+  int32_t y0 = curve[idx];
+  int32_t y1 = curve[idx + 1];
+  return y0 + (((y1 - y0) * frac) >> shift);
+}
+
+/**
+ * Pression d'une touche: normalisation -> courbe -> slew limiter -> moyenne mobile.
+ *
+ * - process() prend la chute courante, la chute au moment de l'appui (zone morte comprise)
+ *   et la chute max calibrée; une touche relâchée a une cible nulle
+ * - Deux implémentations de même interface, toujours compilées pour pouvoir être comparées:
+ *   PressureChainFixed (entiers, Q15 et Q4) et PressureChainFloat (référence flottante).
+ *   AFTERTOUCH_FIXED_POINT choisit celle du clavier
+ */
+class PressureChainFixed {
+public:
+  PressureChainFixed() { reset(); }
+
+  void reset() {
+    _slewed = 0;
+    _smoothed = 0;
+    _average.reset();
+  }
+
+  uint16_t process(bool pressed, uint16_t delta, uint16_t pressDelta, uint16_t maxDelta, const uint16_t* curve);
+  uint16_t value() const { return _smoothed; }
+
+private:
+  int32_t  _slewed;    // Q4
+  uint16_t _smoothed;  // 0..CV_OUTPUT_RESOLUTION
+  RunningAverage<AFTERTOUCH_SMOOTHING_WINDOW_SIZE> _average;  // Historique Q4
+};
+
+class PressureChainFloat {
+public:
+  PressureChainFloat() { reset(); }
+
+  void reset() {
+    _slewed = 0.0f;
+    _smoothed = 0.0f;
+    _average.reset();
+  }
+
+  uint16_t process(bool pressed, uint16_t delta, uint16_t pressDelta, uint16_t maxDelta, const uint16_t* curve);
+  uint16_t value() const { return (uint16_t)_smoothed; }
+
+private:
+  float _slewed;
+  float _smoothed;
+  RunningAverage<AFTERTOUCH_SMOOTHING_WINDOW_SIZE> _average;  // Historique entier en Q4
+};
+
+#if AFTERTOUCH_FIXED_POINT
+typedef PressureChainFixed PressureChain;
+#else
+typedef PressureChainFloat PressureChain;
+#endif
+
+#endif // PRESSURE_CHAIN_H
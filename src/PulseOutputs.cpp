@@ -0,0 +1,144 @@
+#include "PulseOutputs.h"
+#include <Arduino.h>
+#include <FspTimer.h>
+
+static const uint8_t OUTPUT_PINS[PulseOutputs::COUNT] = { PIN_TRIGGER, PIN_GATE };
+
+// Timer one-shot partagé avec l'ISR; la fréquence de base ne sert qu'à fixer l'horloge du compteur
+static FspTimer edgeTimer;
+static PulseOutputs* timerOwner = nullptr;
+static const float EDGE_TIMER_BASE_HZ = 1000.0f;
+// Période maximale d'un armement: get_available_timer() peut rendre un canal AGT ou GPT 16 bits
+static const uint32_t EDGE_TIMER_MAX_COUNTS = 0xFFFF;
+
+static void onEdgeTimer(timer_callback_args_t* args) {
+  (void)args;
+  if (timerOwner) timerOwner->onTimer();
+}
+
+// a est-il atteint à l'instant now (différence signée: insensible au rebouclage de micros())
+static inline bool isDue(uint32_t at, uint32_t now) {
+  return (int32_t)(now - at) >= 0;
+}
+
+PulseOutputs::PulseOutputs() {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    _risePending[i] = false;
+    _fallPending[i] = false;
+    _level[i] = false;
+    _riseAt[i] = 0;
+    _fallAt[i] = 0;
+  }
+  _countsPerMicro = 1;
+  _maxDelay_us = 1;
+  _ready = false;
+}
+
+bool PulseOutputs::begin() {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    pinMode(OUTPUT_PINS[i], OUTPUT);
+    writeOutput(i, false);
+  }
+
+  uint8_t timerType;
+  int8_t channel = FspTimer::get_available_timer(timerType);
+  if (channel < 0 ||
+      !edgeTimer.begin(TIMER_MODE_ONE_SHOT, timerType, channel, EDGE_TIMER_BASE_HZ, 0.0f, onEdgeTimer) ||
+      !edgeTimer.setup_overflow_irq() || !edgeTimer.open()) {
+    #if DEBUG_LEVEL >= 0
+    Serial.println("FATAL: Aucun timer libre pour les sorties trigger/gate");
+    #endif
+    return false;
+  }
+  // Période de base en comptes du timer -> comptes par µs (dépend du prédiviseur choisi)
+  _countsPerMicro = edgeTimer.get_period_raw() / (uint32_t)(1000000.0f / EDGE_TIMER_BASE_HZ);
+  if (_countsPerMicro == 0) _countsPerMicro = 1;
+  _maxDelay_us = EDGE_TIMER_MAX_COUNTS / _countsPerMicro;
+  if (_maxDelay_us == 0) return false;
+  timerOwner = this;
+  _ready = true;
+  return true;
+}
+
+void PulseOutputs::writeOutput(uint8_t output, bool level) {
+  _level[output] = level;
+  digitalWrite(OUTPUT_PINS[output], level ? HIGH : LOW);
+}
+
+void PulseOutputs::schedulePulse(Output output, uint32_t rise_us, uint32_t width_us) {
+  noInterrupts();
+  _riseAt[output] = rise_us;
+  _fallAt[output] = rise_us + width_us;
+  _risePending[output] = true;
+  _fallPending[output] = true;
+  uint32_t now = micros();
+  applyDueEdges(now);
+  armNextEdge(now);
+  interrupts();
+}
+
+void PulseOutputs::setLevel(Output output, bool level) {
+  // Appelé à chaque trame moteur: rien à faire si le niveau est déjà tenu
+  if (!isPending(output) && _level[output] == level) return;
+  noInterrupts();
+  _risePending[output] = false;
+  _fallPending[output] = false;
+  writeOutput(output, level);
+  armNextEdge(micros());
+  interrupts();
+}
+
+void PulseOutputs::clear() {
+  noInterrupts();
+  for (uint8_t i = 0; i < COUNT; i++) {
+    _risePending[i] = false;
+    _fallPending[i] = false;
+    writeOutput(i, false);
+  }
+  if (_ready) edgeTimer.stop();
+  interrupts();
+}
+
+void PulseOutputs::onTimer() {
+  uint32_t now = micros();
+  applyDueEdges(now);
+  armNextEdge(now);
+}
+
+void PulseOutputs::applyDueEdges(uint32_t now) {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    if (_risePending[i] && isDue(_riseAt[i], now)) {
+      _risePending[i] = false;
+      writeOutput(i, true);
+    }
+    // Le front descendant suit toujours le montant de la même impulsion
+    if (_fallPending[i] && !_risePending[i] && isDue(_fallAt[i], now)) {
+      _fallPending[i] = false;
+      writeOutput(i, false);
+    }
+  }
+}
+
+void PulseOutputs::armNextEdge(uint32_t now) {
+  if (!_ready) return;
+  bool found = false;
+  uint32_t nextDelay = 0;
+  for (uint8_t i = 0; i < COUNT; i++) {
+    uint32_t at;
+    if (_risePending[i]) at = _riseAt[i];
+    else if (_fallPending[i]) at = _fallAt[i];
+    else continue;
+    uint32_t delay = isDue(at, now) ? 1 : at - now;
+    if (!found || delay < nextDelay) {
+      nextDelay = delay;
+      found = true;
+    }
+  }
+  edgeTimer.stop();
+  if (!found) return;
+  // Échéance hors de la plage du compteur: le timer tombe en avance, onTimer() ne pose aucun
+  // front et réarme pour le reste
+  if (nextDelay > _maxDelay_us) nextDelay = _maxDelay_us;
+  if (!edgeTimer.set_period(nextDelay * _countsPerMicro)) return;
+  edgeTimer.start();
+}
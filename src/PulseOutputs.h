@@ -0,0 +1,66 @@
+#ifndef PULSE_OUTPUTS_H
+#define PULSE_OUTPUTS_H
+
+#include <stdint.h>
+#include "HardwareConfig.h"
+
+/**
+ * Sorties logiques TRIGGER et GATE avec fronts datés à la microseconde.
+ *
+ * - Les fronts immédiats sont écrits tout de suite; les fronts futurs (fin de trigger, fin de
+ *   gate d'arpège, front montant différé) sont posés par un timer matériel en mode one-shot,
+ *   réarmé sur l'échéance suivante: la largeur ne dépend pas de la charge de la boucle
+ * - Un seul front montant et un seul front descendant en attente par sortie; reprogrammer
+ *   une sortie remplace ses fronts en attente
+ * - Les échéances sont des valeurs de micros() (comparaisons modulo 2^32); une échéance plus
+ *   lointaine que la plage du compteur est atteinte en plusieurs armements
+ */
+class PulseOutputs {
+public:
+  enum Output : uint8_t { TRIGGER = 0, GATE = 1, COUNT = 2 };
+
+  PulseOutputs();
+
+  /**
+   * @brief Configure les broches (niveau bas) et le timer one-shot.
+   * @return false si aucun timer n'est disponible.
+   */
+  bool begin();
+
+  /**
+   * @brief Impulsion: front montant à rise_us (immédiat si déjà passé), descendant width_us plus tard.
+   */
+  void schedulePulse(Output output, uint32_t rise_us, uint32_t width_us);
+
+  /**
+   * @brief Niveau maintenu, immédiat; annule les fronts en attente de la sortie.
+   */
+  void setLevel(Output output, bool level);
+
+  /**
+   * @brief Toutes les sorties à 0, plus aucun front en attente (changement de mode).
+   */
+  void clear();
+
+  // Une impulsion de cette sortie est-elle encore en cours (front montant ou descendant à venir)
+  bool isPending(Output output) const { return _risePending[output] || _fallPending[output]; }
+
+  // Appelé par l'interruption du timer: pose les fronts échus et réarme le timer
+  void onTimer();
+
+private:
+  void applyDueEdges(uint32_t now);
+  void armNextEdge(uint32_t now);
+  void writeOutput(uint8_t output, bool level);
+
+  volatile bool _risePending[COUNT];
+  volatile bool _fallPending[COUNT];
+  volatile bool _level[COUNT];
+  uint32_t      _riseAt[COUNT];
+  uint32_t      _fallAt[COUNT];
+  uint32_t      _countsPerMicro;
+  uint32_t      _maxDelay_us;    // Plus long délai d'un seul armement du compteur
+  bool          _ready;
+};
+
+#endif // PULSE_OUTPUTS_H
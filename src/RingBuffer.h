@@ -0,0 +1,69 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+
+/**
+ * File circulaire de taille fixe (puissance de deux), sans allocation.
+ *
+ * - Un seul producteur et un seul consommateur: chacun n'écrit que son propre index, le
+ *   producteur peut être une interruption tant que le consommateur ne l'est pas
+ * - Les index courent librement sur 16 bits; occupation = head - tail (modulo 2^16)
+ * - File pleine: push() refuse l'élément et le compte, rien n'est écrasé
+ * - Barrière compilateur entre l'élément et la publication de l'index (cœur unique: suffisant)
+ */
+template <typename T, uint16_t SIZE>
+class RingBuffer {
+  static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "RingBuffer: SIZE doit etre une puissance de deux");
+
+public:
+  RingBuffer() : _head(0), _tail(0), _maxSize(0), _dropped(0) {}
+
+  bool push(const T& item) {
+    uint16_t head = _head;
+    if ((uint16_t)(head - _tail) >= SIZE) {
+      _dropped++;
+      return false;
+    }
+    _items[head & (SIZE - 1)] = item;
+    __asm__ __volatile__("" ::: "memory");
+    _head = head + 1;  // Publié après l'écriture de l'élément
+    uint16_t used = (uint16_t)(head + 1 - _tail);
+    if (used > _maxSize) _maxSize = used;
+    return true;
+  }
+
+  bool pop(T& item) {
+    uint16_t tail = _tail;
+    if (tail == _head) return false;
+    item = _items[tail & (SIZE - 1)];
+    __asm__ __volatile__("" ::: "memory");
+    _tail = tail + 1;  // La place n'est rendue qu'une fois l'élément lu
+    return true;
+  }
+
+  bool peek(T& item) const {
+    uint16_t tail = _tail;
+    if (tail == _head) return false;
+    item = _items[tail & (SIZE - 1)];
+    return true;
+  }
+
+  // Vide la file côté consommateur
+  void clear() { _tail = _head; }
+
+  uint16_t size() const { return (uint16_t)(_head - _tail); }
+  bool     isEmpty() const { return _head == _tail; }
+  uint16_t capacity() const { return SIZE; }
+  uint16_t getMaxSize() const { return _maxSize; }  // Occupation maximale atteinte
+  uint32_t getDroppedCount() const { return _dropped; }
+
+private:
+  T _items[SIZE];
+  volatile uint16_t _head;   // Écrit par le producteur seul
+  volatile uint16_t _tail;   // Écrit par le consommateur seul
+  volatile uint16_t _maxSize;
+  volatile uint32_t _dropped;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,51 @@
+#ifndef RUNNING_AVERAGE_H
+#define RUNNING_AVERAGE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Moyenne mobile à somme glissante sur WINDOW échantillons 16 bits.
+ *
+ * - Coût constant par échantillon (une soustraction, une addition), quelle que soit la fenêtre
+ * - Stockage entier: WINDOW x 2 octets + somme 32 bits
+ * - Fenêtre en puissance de 2 conseillée: la division devient un décalage
+ */
+template <uint8_t WINDOW>
+class RunningAverage {
+  static_assert(WINDOW > 0, "Fenetre vide");
+  static_assert((uint32_t)WINDOW * 0xFFFF <= 0xFFFFFFFF, "La somme doit tenir sur 32 bits");
+
+public:
+  RunningAverage() {
+    reset();
+  }
+
+  void reset() {
+    memset(_ring, 0, sizeof(_ring));
+    _sum = 0;
+    _index = 0;
+  }
+
+  /**
+   * Ajoute un échantillon et renvoie la moyenne de la fenêtre
+   */
+  uint16_t push(uint16_t value) {
+    _sum += value;
+    _sum -= _ring[_index];
+    _ring[_index] = value;
+    _index = (_index + 1 == WINDOW) ? 0 : _index + 1;
+    return (uint16_t)(_sum / WINDOW);
+  }
+
+  uint16_t average() const {
+    return (uint16_t)(_sum / WINDOW);
+  }
+
+private:
+  uint16_t _ring[WINDOW];
+  uint32_t _sum;
+  uint8_t  _index;
+};
+
+#endif // RUNNING_AVERAGE_H
@@ -1,4 +1,5 @@
 #include "SimpleEncoder.h"
+#include <pinDefinitions.h>
 
 // Quadrature state transition table
 // [current_state][new_state] = direction
@@ -9,3 +10,73 @@ const int SimpleEncoder::QUAD_STATES[4][4] = {
   {1,  0,  0, -1},  // State 2: 10 -> valid transitions to 0(+1) or 3(-1)
   {0, -1,  1,  0}   // State 3: 11 -> valid transitions to 1(-1) or 2(+1)
 };
+
+SimpleEncoder* SimpleEncoder::_instance = nullptr;
+
+SimpleEncoder::SimpleEncoder(int pinA, int pinB)
+  : _pinA(pinA), _pinB(pinB) {
+  _state = 0;
+  _accumulator = 0;
+  _lastEdgeMicros = 0;
+  _interruptDriven = false;
+}
+
+bool SimpleEncoder::begin() {
+  // Initialize pins with internal pull-ups
+  pinMode(_pinA, INPUT_PULLUP);
+  pinMode(_pinB, INPUT_PULLUP);
+  reset();
+
+  // digitalPinToInterrupt() is the identity on this core and never reports a missing IRQ:
+  // ask for the pin's IRQ channel the way the core's attachInterrupt() does
+  if (!hasIrqChannel(_pinA) || !hasIrqChannel(_pinB)) {
+    _interruptDriven = false;
+    return false;
+  }
+  _instance = this;
+  attachInterrupt(digitalPinToInterrupt(_pinA), onEdgeIsr, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(_pinB), onEdgeIsr, CHANGE);
+  _interruptDriven = true;
+  return true;
+}
+
+bool SimpleEncoder::hasIrqChannel(int pin) {
+  return getPinCfgs(pin, PIN_CFG_REQ_INTERRUPT)[0] != 0;
+}
+
+void SimpleEncoder::onEdgeIsr() {
+  if (_instance) _instance->sampleEdge();
+}
+
+void SimpleEncoder::sampleEdge() {
+  int newState = (digitalRead(_pinA) << 1) | digitalRead(_pinB);
+  int direction = QUAD_STATES[_state][newState];
+  if (direction != 0) {
+    _state = newState;
+    _accumulator += direction;
+    _lastEdgeMicros = micros();
+  }
+}
+
+int SimpleEncoder::read(uint32_t* lastEdgeMicros) {
+  if (!_interruptDriven) {
+    sampleEdge();
+  }
+
+  noInterrupts();
+  int steps = _accumulator;
+  _accumulator = 0;
+  uint32_t edge = _lastEdgeMicros;
+  interrupts();
+
+  if (lastEdgeMicros) *lastEdgeMicros = edge;
+  return steps;
+}
+
+void SimpleEncoder::reset() {
+  noInterrupts();
+  _state = (digitalRead(_pinA) << 1) | digitalRead(_pinB);
+  _accumulator = 0;
+  _lastEdgeMicros = micros();
+  interrupts();
+}
@@ -4,100 +4,67 @@
 #include <Arduino.h>
 
 /**
- * Enhanced Rotary Encoder Class with Debouncing
- * 
+ * Interrupt-Driven Rotary Encoder
+ *
  * Features:
- * - Hardware debouncing with configurable timeout
- * - Complete quadrature state machine
- * - Noise filtering and validation
- * - Configurable sensitivity
+ * - Quadrature state machine run on every edge of A and B (CHANGE interrupts)
+ * - Steps summed into an accumulator that read() takes and clears atomically:
+ *   no edge is lost however late the loop polls
+ * - Contact bounce needs no time debounce: a bounce is a +1/-1 pair that cancels in the
+ *   accumulator, and impossible jumps (both pins changed) are rejected by the state table
+ * - Each counted edge is timestamped in micros(), so speed can be measured from real edge
+ *   timing instead of from poll timing
+ * - Falls back to polling the same state machine if a pin has no IRQ channel
  */
 class SimpleEncoder {
 private:
   int _pinA, _pinB;
-  int _lastStateA, _lastStateB;
-  unsigned long _lastChangeTime;
-  int _state;  // Current quadrature state (0-3)
-  
+  volatile int _state;              // Current quadrature state (0-3)
+  volatile int _accumulator;        // Steps not yet taken by read()
+  volatile uint32_t _lastEdgeMicros;
+  bool _interruptDriven;
+
   // Quadrature state machine - [current_state][new_state] = direction
   static const int QUAD_STATES[4][4];
-  
+
+  static SimpleEncoder* _instance;  // Target of the edge interrupts (one encoder)
+  static void onEdgeIsr();
+  static bool hasIrqChannel(int pin);
+
+  void sampleEdge();
+
 public:
-  // Expose debouncing time as public constant for easy configuration
-  static const unsigned long DEFAULT_DEBOUNCE_TIME_MS = 2;
-  unsigned long debounceTimeMs;
-  
-  SimpleEncoder(int pinA, int pinB, unsigned long debounceMs = DEFAULT_DEBOUNCE_TIME_MS) 
-    : _pinA(pinA), _pinB(pinB), debounceTimeMs(debounceMs) {
-    
-    // Initialize pins with internal pull-ups
-    pinMode(_pinA, INPUT_PULLUP);
-    pinMode(_pinB, INPUT_PULLUP);
-    
-    // Read initial state
-    _lastStateA = digitalRead(_pinA);
-    _lastStateB = digitalRead(_pinB);
-    _state = (_lastStateA << 1) | _lastStateB;  // Combine into state
-    _lastChangeTime = millis();
-  }
-  
+  SimpleEncoder(int pinA, int pinB);
+
   /**
-   * Read encoder movement with debouncing
-   * @return +1 (clockwise), -1 (counter-clockwise), or 0 (no change)
+   * Configure pins and attach the edge interrupts
+   * @return false if polling is used instead (pin without interrupt)
    */
-  int read() {
-    int currentStateA = digitalRead(_pinA);
-    int currentStateB = digitalRead(_pinB);
-    unsigned long now = millis();
-    
-    // Debounce: ignore changes too close together
-    if (now - _lastChangeTime < debounceTimeMs) {
-      return 0;
-    }
-    
-    // Check if state actually changed
-    if (currentStateA == _lastStateA && currentStateB == _lastStateB) {
-      return 0;
-    }
-    
-    // Update state
-    int newState = (currentStateA << 1) | currentStateB;
-    int direction = QUAD_STATES[_state][newState];
-    
-    if (direction != 0) {
-      _state = newState;
-      _lastStateA = currentStateA;
-      _lastStateB = currentStateB;
-      _lastChangeTime = now;
-      return direction;
-    }
-    
-    return 0;
-  }
-  
+  bool begin();
+
   /**
-   * Reset encoder state (useful for initialization)
+   * Take the movement accumulated since the previous call
+   * @param lastEdgeMicros If not null, receives the micros() timestamp of the most recent
+   *                       counted edge (only meaningful when the result is non-zero)
+   * @return Signed number of quadrature steps (positive = clockwise)
    */
-  void reset() {
-    _lastStateA = digitalRead(_pinA);
-    _lastStateB = digitalRead(_pinB);
-    _state = (_lastStateA << 1) | _lastStateB;
-    _lastChangeTime = millis();
-  }
-  
+  int read(uint32_t* lastEdgeMicros = nullptr);
+
   /**
-   * Set debounce time
+   * Reset encoder state (useful for initialization)
    */
-  void setDebounceTime(unsigned long ms) {
-    debounceTimeMs = ms;
-  }
-  
+  void reset();
+
   /**
    * Get current quadrature state (for debugging)
    */
   int getState() const {
     return _state;
   }
+
+  bool isInterruptDriven() const {
+    return _interruptDriven;
+  }
 };
 
 
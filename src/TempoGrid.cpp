@@ -0,0 +1,32 @@
+#include "TempoGrid.h"
+
+TempoGrid::TempoGrid() {
+  _next_us = 0;
+  _period_us = 0;
+  _remainder = 0;
+  _frac = 0;
+  _divisor = 1;
+}
+
+void TempoGrid::setPeriod(uint32_t numerator_us, uint16_t divisor) {
+  if (divisor == 0) divisor = 1;
+  _period_us = numerator_us / divisor;
+  _remainder = (uint16_t)(numerator_us % divisor);
+  _divisor = divisor;
+  _frac = 0;  // Phase sous-µs perdue une fois par changement de période, jamais accumulée
+}
+
+void TempoGrid::restart(uint32_t now_us) {
+  _next_us = now_us;
+  _frac = 0;
+  advance();
+}
+
+void TempoGrid::advance() {
+  _next_us += _period_us;
+  _frac += _remainder;
+  if (_frac >= _divisor) {
+    _frac -= _divisor;
+    _next_us++;
+  }
+}
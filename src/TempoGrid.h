@@ -0,0 +1,46 @@
+#ifndef TEMPO_GRID_H
+#define TEMPO_GRID_H
+
+#include <stdint.h>
+
+/**
+ * Grille d'échéances périodiques en micros(), sans dérive.
+ *
+ * - La période est une fraction exacte numerator / divisor µs (ex. 60e6 / bpm pour une noire,
+ *   2.5e6 / bpm pour un tick d'horloge MIDI à 24 ppqn)
+ * - Partie entière + reste accumulé à la Bresenham: la n-ième échéance est à moins d'une µs de
+ *   sa valeur exacte, quel que soit n
+ * - Comparaisons modulo 2^32: insensible au rebouclage de micros()
+ */
+class TempoGrid {
+public:
+  TempoGrid();
+
+  /**
+   * @brief Période = numerator / divisor µs, appliquée à partir de la prochaine échéance.
+   */
+  void setPeriod(uint32_t numerator_us, uint16_t divisor);
+
+  /**
+   * @brief L'échéance courante est now_us; la suivante est une période plus tard.
+   */
+  void restart(uint32_t now_us);
+
+  /**
+   * @brief Passe à l'échéance suivante (exactement une période).
+   */
+  void advance();
+
+  bool     isDue(uint32_t now_us) const { return (int32_t)(now_us - _next_us) >= 0; }
+  uint32_t next() const { return _next_us; }
+  uint32_t period() const { return _period_us; }  // Partie entière
+
+private:
+  uint32_t _next_us;
+  uint32_t _period_us;
+  uint16_t _remainder;  // Partie fractionnaire, en 1/_divisor µs
+  uint16_t _frac;       // Fraction accumulée (< _divisor)
+  uint16_t _divisor;
+};
+
+#endif // TEMPO_GRID_H
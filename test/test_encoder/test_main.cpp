@@ -0,0 +1,65 @@
+// =================================================================
+// SimpleEncoder: comptage par interruptions, repli en scrutation sans canal IRQ
+// =================================================================
+// Un cran sens horaire depuis le repos (pull-ups, état 11): 10 -> 00 -> 01 -> 11, soit +4 pas.
+#include <unity.h>
+#include <Arduino.h>
+#include "HostHal.h"
+#include "HardwareConfig.h"
+#include "SimpleEncoder.h"
+
+static const int CLOCKWISE[4][2] = { { 1, 0 }, { 0, 0 }, { 0, 1 }, { 1, 1 } };
+
+static void setLines(int a, int b) {
+  hostSetPinInput(PIN_ENCODER_A, a);
+  hostSetPinInput(PIN_ENCODER_B, b);
+}
+
+void setUp(void) {
+  hostSetPinInterruptCapable(PIN_ENCODER_A, true);
+  hostSetPinInterruptCapable(PIN_ENCODER_B, true);
+  setLines(1, 1);
+}
+
+void tearDown(void) {
+  detachInterrupt(digitalPinToInterrupt(PIN_ENCODER_A));
+  detachInterrupt(digitalPinToInterrupt(PIN_ENCODER_B));
+}
+
+void test_interrupts_count_edges_between_reads(void) {
+  SimpleEncoder encoder(PIN_ENCODER_A, PIN_ENCODER_B);
+  TEST_ASSERT_TRUE(encoder.begin());
+  TEST_ASSERT_TRUE(encoder.isInterruptDriven());
+
+  // Tout le cran passe entre deux lectures: les fronts sont comptés dans l'ISR
+  for (int i = 0; i < 4; i++) setLines(CLOCKWISE[i][0], CLOCKWISE[i][1]);
+  TEST_ASSERT_EQUAL_INT(ENCODER_STEPS_PER_DETENT, encoder.read());
+  TEST_ASSERT_EQUAL_INT(0, encoder.read());
+
+  for (int i = 3; i >= 0; i--) setLines(CLOCKWISE[i][0], CLOCKWISE[i][1]);
+  setLines(1, 1);
+  TEST_ASSERT_EQUAL_INT(-ENCODER_STEPS_PER_DETENT, encoder.read());
+}
+
+void test_pin_without_irq_falls_back_to_polling(void) {
+  hostSetPinInterruptCapable(PIN_ENCODER_B, false);
+  SimpleEncoder encoder(PIN_ENCODER_A, PIN_ENCODER_B);
+  TEST_ASSERT_FALSE(encoder.begin());
+  TEST_ASSERT_FALSE(encoder.isInterruptDriven());
+
+  // Aucun front vu hors lecture: chaque lecture échantillonne la machine d'états
+  int steps = 0;
+  for (int i = 0; i < 4; i++) {
+    setLines(CLOCKWISE[i][0], CLOCKWISE[i][1]);
+    steps += encoder.read();
+  }
+  TEST_ASSERT_EQUAL_INT(ENCODER_STEPS_PER_DETENT, steps);
+}
+
+int main() {
+  hostSerialSetTextOutput(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_interrupts_count_edges_between_reads);
+  RUN_TEST(test_pin_without_irq_falls_back_to_polling);
+  return UNITY_END();
+}
@@ -0,0 +1,160 @@
+// =================================================================
+// EngineMode1: pile de notes (priorité à la dernière), latch, octave
+// =================================================================
+#include <unity.h>
+#include "HostHal.h"
+#include "EngineMode1.h"
+#include "PitchCalibration.h"
+
+static PitchCalibration pitchCal;  // Table idéale
+static EngineMode1* engine;
+static bool heldKeys[NUM_KEYS];
+
+static uint16_t codeOf(uint8_t note) { return pitchCal.noteToCode(note); }
+
+// Sortie après un passage de update() (glide nul: le code rejoint la cible)
+static uint16_t pitchOut() {
+  engine->update();
+  return engine->getPitchCode();
+}
+
+static void pressHold() {
+  InputEvent event = {};
+  event.type = InputEventType::HOLD_SHORT;
+  engine->handleInput(event, heldKeys);
+}
+
+void setUp(void) {
+  engine = new EngineMode1();
+  engine->begin(pitchCal);
+  for (int i = 0; i < NUM_KEYS; i++) heldKeys[i] = false;
+}
+
+void tearDown(void) {
+  delete engine;
+}
+
+void test_last_note_priority(void) {
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(52, 500);
+  engine->onNoteOn(55, 500);
+  TEST_ASSERT_EQUAL_UINT16(codeOf(55), pitchOut());
+
+  // Relâcher une note du milieu ne change pas la note jouée
+  engine->onNoteOff(52);
+  TEST_ASSERT_EQUAL_UINT16(codeOf(55), pitchOut());
+
+  // Relâcher la note jouée revient à la précédente encore tenue
+  engine->onNoteOff(55);
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48), pitchOut());
+  TEST_ASSERT_TRUE(engine->getGateState());
+
+  // Pile vide: gate fermé, la hauteur reste sur la dernière note
+  engine->onNoteOff(48);
+  TEST_ASSERT_FALSE(engine->getGateState());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48), pitchOut());
+}
+
+void test_repress_moves_note_to_top(void) {
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(52, 500);
+  engine->onNoteOn(48, 500);
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48), pitchOut());
+
+  // Une seule entrée par hauteur: relâcher 48 revient à 52
+  engine->onNoteOff(48);
+  TEST_ASSERT_EQUAL_UINT16(codeOf(52), pitchOut());
+  engine->onNoteOff(52);
+  TEST_ASSERT_FALSE(engine->getGateState());
+}
+
+void test_stack_overflow_drops_oldest(void) {
+  // NOTE_STACK_SIZE + 1 notes: la première est sortie de la pile
+  for (int i = 0; i <= NOTE_STACK_SIZE; i++) engine->onNoteOn(36 + i, 500);
+  for (int i = NOTE_STACK_SIZE; i >= 1; i--) {
+    TEST_ASSERT_EQUAL_UINT16(codeOf(36 + i), pitchOut());
+    engine->onNoteOff(36 + i);
+  }
+  TEST_ASSERT_FALSE(engine->getGateState());
+}
+
+void test_retrigger_on_new_active_note(void) {
+  engine->onNoteOn(48, 500);
+  TEST_ASSERT_TRUE(engine->getAndClearRetriggerEvent());
+  TEST_ASSERT_FALSE(engine->getAndClearRetriggerEvent());
+
+  // Le retour à une note tenue redéclenche aussi l'enveloppe
+  engine->onNoteOn(52, 500);
+  TEST_ASSERT_TRUE(engine->getAndClearRetriggerEvent());
+  engine->onNoteOff(52);
+  TEST_ASSERT_TRUE(engine->getAndClearRetriggerEvent());
+}
+
+void test_latch_holds_released_notes(void) {
+  pressHold();
+  TEST_ASSERT_TRUE(engine->isLatchActive());
+
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(55, 500);
+  engine->onNoteOff(55);
+  engine->onNoteOff(48);
+  TEST_ASSERT_TRUE(engine->getGateState());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(55), pitchOut());
+}
+
+void test_unlatch_keeps_only_held_keys(void) {
+  pressHold();
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(55, 500);
+  engine->onNoteOff(55);
+
+  // Seule la touche de 48 est encore enfoncée au moment de quitter le latch
+  heldKeys[48 - 36] = true;
+  pressHold();
+  TEST_ASSERT_FALSE(engine->isLatchActive());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48), pitchOut());
+
+  heldKeys[48 - 36] = false;
+  engine->onNoteOff(48);
+  TEST_ASSERT_FALSE(engine->getGateState());
+}
+
+void test_unlatch_with_no_key_held_closes_gate(void) {
+  pressHold();
+  engine->onNoteOn(50, 500);
+  engine->onNoteOff(50);
+  pressHold();
+  TEST_ASSERT_FALSE(engine->getGateState());
+}
+
+void test_octave_offset_clamped(void) {
+  engine->onNoteOn(48, 500);
+  InputEvent up = {};
+  up.type = InputEventType::OCT_PLUS_SHORT;
+  engine->handleInput(up, heldKeys);
+  TEST_ASSERT_EQUAL_INT(1, engine->getOctaveOffset());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(60), pitchOut());
+
+  for (int i = 0; i < 5; i++) engine->handleInput(up, heldKeys);
+  TEST_ASSERT_EQUAL_INT(MAX_OCTAVE, engine->getOctaveOffset());
+
+  InputEvent down = {};
+  down.type = InputEventType::OCT_MINUS_SHORT;
+  for (int i = 0; i < 10; i++) engine->handleInput(down, heldKeys);
+  TEST_ASSERT_EQUAL_INT(MIN_OCTAVE, engine->getOctaveOffset());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48 + 12 * MIN_OCTAVE), pitchOut());
+}
+
+int main() {
+  hostSerialSetTextOutput(false);  // Traces DEBUG_LEVEL du moteur
+  UNITY_BEGIN();
+  RUN_TEST(test_last_note_priority);
+  RUN_TEST(test_repress_moves_note_to_top);
+  RUN_TEST(test_stack_overflow_drops_oldest);
+  RUN_TEST(test_retrigger_on_new_active_note);
+  RUN_TEST(test_latch_holds_released_notes);
+  RUN_TEST(test_unlatch_keeps_only_held_keys);
+  RUN_TEST(test_unlatch_with_no_key_held_closes_gate);
+  RUN_TEST(test_octave_offset_clamped);
+  return UNITY_END();
+}
@@ -0,0 +1,245 @@
+// =================================================================
+// EngineMode2: ordre des pas, grille et shuffle, latch/double appui, tempo
+// =================================================================
+#include <unity.h>
+#include <stdio.h>
+#include <Arduino.h>
+#include "HostHal.h"
+#include "EngineMode2.h"
+#include "PitchCalibration.h"
+
+// Période de update() simulée: les pas tombent au plus UPDATE_US après leur échéance
+static const uint32_t UPDATE_US = 10;
+static const uint32_t BEAT_US_FOR_TEST = 60000000UL;
+
+static PitchCalibration pitchCal;  // Table idéale
+static EngineMode2* engine;
+static bool heldKeys[NUM_KEYS];
+
+static uint16_t codeOf(uint8_t note) { return pitchCal.noteToCode(note); }
+
+// Fait tourner update() jusqu'au prochain retrigger; renvoie son instant (µs virtuelles)
+static uint64_t runToNextStep() {
+  for (uint32_t guard = 0; guard < 10000000UL / UPDATE_US; guard++) {
+    hostAdvanceMicros(UPDATE_US);
+    engine->update();
+    if (engine->getAndClearRetriggerEvent()) return hostNowMicros();
+  }
+  TEST_FAIL_MESSAGE("aucun pas en 10 s");
+  return 0;
+}
+
+static void sendEncoder(int16_t clicks, uint8_t modifiers) {
+  InputEvent event = {};
+  event.type = InputEventType::ENCODER;
+  event.modifiers = modifiers;
+  event.value = clicks;
+  engine->handleInput(event, heldKeys);
+}
+
+static void pressHold() {
+  InputEvent event = {};
+  event.type = InputEventType::HOLD_SHORT;
+  engine->handleInput(event, heldKeys);
+}
+
+void setUp(void) {
+  engine = new EngineMode2();
+  engine->begin(pitchCal);
+  for (int i = 0; i < NUM_KEYS; i++) heldKeys[i] = false;
+}
+
+void tearDown(void) {
+  delete engine;
+}
+
+void test_up_pattern_steps_in_pitch_order(void) {
+  // Ajout dans le désordre: le motif est trié et repart de la note jouée (55, la plus haute)
+  engine->onNoteOn(55, 500);
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(52, 500);
+  engine->getAndClearRetriggerEvent();
+
+  static const uint8_t expected[] = { 48, 52, 55, 48, 52, 55 };
+  for (uint8_t i = 0; i < sizeof(expected); i++) {
+    runToNextStep();
+    TEST_ASSERT_EQUAL_UINT16(codeOf(expected[i]), engine->getPitchCode());
+  }
+}
+
+void test_steps_on_tempo_grid(void) {
+  engine->setTempo(137);  // Période non entière: 437956.2 µs
+  engine->onNoteOn(48, 500);
+  uint64_t start_us = hostNowMicros();
+  engine->onNoteOn(55, 500);
+  engine->getAndClearRetriggerEvent();
+
+  for (uint32_t step = 1; step <= 64; step++) {
+    uint64_t ideal_us = start_us + (uint64_t)step * 60000000ULL / 137;
+    int64_t error_us = (int64_t)(runToNextStep() - ideal_us);
+    TEST_ASSERT_INT_WITHIN(UPDATE_US, UPDATE_US / 2, error_us);
+  }
+  TEST_ASSERT_EQUAL_UINT32(60000000UL / 137 / 2, engine->getGateLength_us());
+}
+
+void test_shuffle_delays_off_beat_steps_only(void) {
+  // 20 crans: profondeur 0.1 du gabarit 1 (retard de 50% de la période aux pas 2 et 6 du cycle)
+  sendEncoder(20, INPUT_MOD_SHIFT_MINUS);
+  TEST_ASSERT_INT_WITHIN(1, 100, (int)(engine->getShuffleDepth() * 1000.0f + 0.5f));
+  TEST_ASSERT_EQUAL_UINT8(0, engine->getTemplate());
+
+  engine->onNoteOn(48, 500);
+  uint64_t start_us = hostNowMicros();
+  engine->onNoteOn(55, 500);
+  engine->getAndClearRetriggerEvent();
+
+  const uint32_t period_us = 500000;  // 120 BPM
+  const int32_t swing_us = (int32_t)(0.5f * engine->getShuffleDepth() * period_us);
+  for (uint32_t step = 1; step <= 2 * SHUFFLE_STEPS_PER_CYCLE; step++) {
+    uint8_t cyclePosition = (step - 1) % SHUFFLE_STEPS_PER_CYCLE;
+    int32_t expected_us = (cyclePosition == 2 || cyclePosition == 6) ? swing_us : 0;
+    int64_t error_us = (int64_t)(runToNextStep() - (start_us + (uint64_t)step * period_us));
+    TEST_ASSERT_INT_WITHIN(UPDATE_US, expected_us + UPDATE_US / 2, error_us);
+  }
+}
+
+void test_shuffle_encoder_walks_templates(void) {
+  // Au-delà de SHUFFLE_DEPTH_MAX on passe au gabarit suivant, profondeur remise à zéro
+  int clicksPerTemplate = (int)(SHUFFLE_DEPTH_MAX / SHUFFLE_DEPTH_STEP) + 1;
+  sendEncoder(clicksPerTemplate, INPUT_MOD_SHIFT_MINUS);
+  TEST_ASSERT_EQUAL_UINT8(1, engine->getTemplate());
+  TEST_ASSERT_EQUAL_INT(0, (int)(engine->getShuffleDepth() * 1000.0f));
+
+  // En dessous de zéro: gabarit précédent à pleine profondeur
+  sendEncoder(-1, INPUT_MOD_SHIFT_MINUS);
+  TEST_ASSERT_EQUAL_UINT8(0, engine->getTemplate());
+  TEST_ASSERT_EQUAL_INT((int)(SHUFFLE_DEPTH_MAX * 1000.0f + 0.5f), (int)(engine->getShuffleDepth() * 1000.0f + 0.5f));
+}
+
+void test_no_drift_over_10000_steps_with_shuffle_and_tempo_changes(void) {
+  // Pas joués contre la grille rationnelle exacte, sur 10 000 pas avec un shuffle profond et un
+  // tempo qui change tous les 2000 pas. Bornes: jamais en avance de plus que les µs sous-entières
+  // perdues aux changements de tempo (une par changement), jamais en retard de plus d'une période
+  // de update(); le shuffle décale les pas de leur propre case sans rien reporter.
+  static const uint16_t tempos[] = { 900, 137, 451, 120, 733 };
+  static const uint32_t STEPS = 10000;
+  static const uint32_t STEPS_PER_TEMPO = 2000;
+  static const uint32_t DRIFT_UPDATE_US = 50;
+
+  sendEncoder(100, INPUT_MOD_SHIFT_MINUS);  // Profondeur 0.5 du gabarit 1
+  engine->setTempo(tempos[0]);
+  engine->onNoteOn(48, 500);
+  uint64_t start_us = hostNowMicros();
+  engine->onNoteOn(55, 500);
+  engine->getAndClearRetriggerEvent();
+
+  // Temps exact du pas n: début du segment de tempo + (n - premier pas du segment) x période
+  double segmentStart_us = (double)BEAT_US_FOR_TEST / tempos[0];
+  uint32_t segmentStep = 1;
+  uint8_t changes = 0;
+  double worstEarly_us = 0.0, worstLate_us = 0.0;
+  uint32_t onGridSteps = 0;
+
+  for (uint32_t step = 1; step <= STEPS; step++) {
+    uint64_t played_us = 0;
+    while (!played_us) {
+      hostAdvanceMicros(DRIFT_UPDATE_US);
+      engine->update();
+      if (engine->getAndClearRetriggerEvent()) played_us = hostNowMicros() - start_us;
+    }
+    double exact_us = segmentStart_us + (double)((uint64_t)(step - segmentStep) * BEAT_US_FOR_TEST) / tempos[changes];
+    double error_us = (double)played_us - exact_us;
+    uint8_t cyclePosition = (step - 1) % SHUFFLE_STEPS_PER_CYCLE;
+    bool shuffled = (SHUFFLE_TEMPLATE_1[cyclePosition] != 0);
+    if (shuffled) {
+      // Retard de swing dans la case du pas, jamais au-delà de la période
+      TEST_ASSERT_TRUE(error_us > 0.0);
+      TEST_ASSERT_TRUE(error_us < (double)BEAT_US_FOR_TEST / tempos[changes]);
+    } else {
+      onGridSteps++;
+      if (-error_us > worstEarly_us) worstEarly_us = -error_us;
+      if (error_us > worstLate_us) worstLate_us = error_us;
+      TEST_ASSERT_TRUE_MESSAGE(error_us > -(double)(changes + 1), "pas en avance sur la grille");
+      TEST_ASSERT_TRUE_MESSAGE(error_us <= (double)DRIFT_UPDATE_US, "pas en retard sur la grille");
+    }
+
+    // Nouveau tempo: s'applique à partir du pas suivant celui déjà programmé
+    if (step % STEPS_PER_TEMPO == 0 && changes + 1 < (uint8_t)(sizeof(tempos) / sizeof(tempos[0]))) {
+      double pending_us = segmentStart_us + (double)((uint64_t)(step + 1 - segmentStep) * BEAT_US_FOR_TEST) / tempos[changes];
+      changes++;
+      engine->setTempo(tempos[changes]);
+      segmentStart_us = pending_us - (double)BEAT_US_FOR_TEST / tempos[changes];
+      segmentStep = step;
+    }
+  }
+
+  char message[128];
+  snprintf(message, sizeof(message), "%u pas sur la grille, %u changements: avance max %.1f us, retard max %.1f us",
+           onGridSteps, changes, worstEarly_us, worstLate_us);
+  TEST_MESSAGE(message);
+}
+
+void test_latch_double_tap_removes_note(void) {
+  pressHold();
+  TEST_ASSERT_TRUE(engine->isLatchActive());
+  engine->onNoteOn(48, 500);
+  engine->onNoteOff(48);
+  engine->update();
+  TEST_ASSERT_TRUE(engine->getGateState());
+
+  // Second appui dans la fenêtre: la note sort du motif
+  hostAdvanceMicros((ARP_DOUBLE_TAP_WINDOW_MS - 50) * 1000UL);
+  engine->onNoteOn(48, 500);
+  engine->update();
+  TEST_ASSERT_FALSE(engine->getGateState());
+}
+
+void test_latch_slow_repress_keeps_note(void) {
+  pressHold();
+  engine->onNoteOn(48, 500);
+  engine->onNoteOff(48);
+
+  hostAdvanceMicros((ARP_DOUBLE_TAP_WINDOW_MS + 50) * 1000UL);
+  engine->onNoteOn(48, 700);
+  engine->update();
+  TEST_ASSERT_TRUE(engine->getGateState());
+  TEST_ASSERT_EQUAL_UINT16(codeOf(48), engine->getPitchCode());
+}
+
+void test_unlatch_keeps_only_held_keys(void) {
+  pressHold();
+  engine->onNoteOn(48, 500);
+  engine->onNoteOn(55, 500);
+  engine->onNoteOff(48);
+  engine->onNoteOff(55);
+
+  heldKeys[55 - 36] = true;
+  pressHold();
+  TEST_ASSERT_FALSE(engine->isLatchActive());
+  engine->update();
+  TEST_ASSERT_EQUAL_UINT16(codeOf(55), engine->getPitchCode());
+  // Une seule note: plus d'arpège, gate tenu sans impulsion
+  TEST_ASSERT_EQUAL_UINT32(0, engine->getGateLength_us());
+}
+
+void test_tempo_clamped(void) {
+  engine->setTempo(1);
+  TEST_ASSERT_EQUAL_UINT16(ARP_BPM_MIN, engine->getTempo());
+  engine->setTempo(ARP_BPM_MAX + 100);
+  TEST_ASSERT_EQUAL_UINT16(ARP_BPM_MAX, engine->getTempo());
+}
+
+int main() {
+  hostSerialSetTextOutput(false);  // Traces DEBUG_LEVEL du moteur
+  UNITY_BEGIN();
+  RUN_TEST(test_up_pattern_steps_in_pitch_order);
+  RUN_TEST(test_steps_on_tempo_grid);
+  RUN_TEST(test_shuffle_delays_off_beat_steps_only);
+  RUN_TEST(test_shuffle_encoder_walks_templates);
+  RUN_TEST(test_no_drift_over_10000_steps_with_shuffle_and_tempo_changes);
+  RUN_TEST(test_latch_double_tap_removes_note);
+  RUN_TEST(test_latch_slow_repress_keeps_note);
+  RUN_TEST(test_unlatch_keeps_only_held_keys);
+  RUN_TEST(test_tempo_clamped);
+  return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// =================================================================
+// CapacitiveKeyboard: hystérésis appui/relâchement et lecture par trame sur les MPR121 simulés
+// =================================================================
+// Calibration par défaut (EEPROM vierge): chute max 400 counts par touche, soit un seuil
+// d'appui à 60 (15%) et de relâchement à 32 (8%). Le modèle arrondit la baseline au multiple
+// de 4 inférieur: la chute vue par le clavier est celle imposée, moins 0 à 3 counts.
+#include <unity.h>
+#include <Arduino.h>
+#include "HostHal.h"
+#include "HostBoard.h"
+#include "CapacitiveKeyboard.h"
+
+static const uint8_t KEY = 5;             // Premier capteur
+static const uint8_t KEY_SENSOR_B = 17;   // Second capteur
+
+static CapacitiveKeyboard* keyboard;
+
+// Un update() lit un seul capteur: deux appels couvrent les 24 touches
+static void scanBoth() {
+  for (int i = 0; i < 2; i++) {
+    keyboard->update();
+    delay(1);
+  }
+}
+
+static void setDeltaAndScan(uint8_t key, uint16_t delta) {
+  hostBoardSetKeyDelta(key, delta);
+  scanBoth();
+}
+
+void setUp(void) {
+  for (uint8_t k = 0; k < NUM_KEYS; k++) hostBoardSetKeyDelta(k, 0);
+  keyboard = new CapacitiveKeyboard();
+  TEST_ASSERT_TRUE(keyboard->begin());
+  scanBoth();
+}
+
+void tearDown(void) {
+  delete keyboard;
+}
+
+void test_idle_keys_released(void) {
+  TEST_ASSERT_EQUAL_UINT32(0, keyboard->getPressedMask());
+}
+
+void test_press_needs_press_threshold(void) {
+  setDeltaAndScan(KEY, 55);
+  TEST_ASSERT_FALSE(keyboard->isPressed(KEY));
+
+  setDeltaAndScan(KEY, 70);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+  TEST_ASSERT_EQUAL_UINT32(1UL << KEY, keyboard->getPressedMask());
+}
+
+void test_release_hysteresis(void) {
+  setDeltaAndScan(KEY, 200);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+
+  // Entre les deux seuils: la touche reste enfoncée
+  setDeltaAndScan(KEY, 45);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+
+  setDeltaAndScan(KEY, 25);
+  TEST_ASSERT_FALSE(keyboard->isPressed(KEY));
+
+  // Et ne se réenfonce pas tant que le seuil d'appui n'est pas repassé
+  setDeltaAndScan(KEY, 45);
+  TEST_ASSERT_FALSE(keyboard->isPressed(KEY));
+}
+
+void test_onset_and_release_masks_once(void) {
+  hostBoardSetKeyDelta(KEY_SENSOR_B, 200);
+  uint32_t onsets = 0;
+  for (int i = 0; i < 2; i++) {
+    keyboard->update();
+    onsets |= keyboard->getOnsetMask();
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1UL << KEY_SENSOR_B, onsets);
+
+  // Touche tenue: pas de nouvel onset aux trames suivantes
+  onsets = 0;
+  for (int i = 0; i < 4; i++) {
+    keyboard->update();
+    onsets |= keyboard->getOnsetMask();
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, onsets);
+
+  hostBoardSetKeyDelta(KEY_SENSOR_B, 0);
+  uint32_t releases = 0;
+  for (int i = 0; i < 2; i++) {
+    keyboard->update();
+    releases |= keyboard->getReleaseMask();
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1UL << KEY_SENSOR_B, releases);
+  TEST_ASSERT_EQUAL_UINT32(0, keyboard->getPressedMask());
+}
+
+void test_thresholds_follow_calibration(void) {
+  // Petite course calibrée: seuils planchers MIN_PRESS_THRESHOLD / MIN_RELEASE_THRESHOLD
+  keyboard->setCalibrationMaxDelta(KEY, 100);
+  keyboard->calculateAdaptiveThresholds();
+
+  setDeltaAndScan(KEY, MIN_PRESS_THRESHOLD + 8);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+  setDeltaAndScan(KEY, MIN_RELEASE_THRESHOLD + 6);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+  setDeltaAndScan(KEY, MIN_RELEASE_THRESHOLD - 5);
+  TEST_ASSERT_FALSE(keyboard->isPressed(KEY));
+}
+
+void test_pressure_rises_with_delta(void) {
+  setDeltaAndScan(KEY, 80);
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY));
+  for (int i = 0; i < 50; i++) scanBoth();
+  uint16_t light = keyboard->getPressure(KEY);
+
+  hostBoardSetKeyDelta(KEY, 380);
+  for (int i = 0; i < 200; i++) scanBoth();
+  uint16_t firm = keyboard->getPressure(KEY);
+  TEST_ASSERT_GREATER_THAN(light, firm);
+
+  // Relâchement: retour à zéro forcé
+  setDeltaAndScan(KEY, 0);
+  TEST_ASSERT_EQUAL_UINT16(0, keyboard->getPressure(KEY));
+}
+
+void test_one_sensor_burst_per_update(void) {
+  // Un burst bloquant de 38 octets par appel, capteurs A puis B: la touche du capteur B
+  // n'apparaît qu'au second appel, horodatée au début de son propre transfert
+  hostBoardSetKeyDelta(KEY_SENSOR_B, 200);
+  uint32_t sequence = keyboard->getFrameSequence();
+
+  unsigned long before_us = micros();
+  uint64_t bytes = hostI2cTotalBytes();
+  keyboard->update();
+  uint64_t burstBytes = hostI2cTotalBytes() - bytes;
+  TEST_ASSERT_EQUAL_UINT32(sequence + 1, keyboard->getFrameSequence());
+  TEST_ASSERT_EQUAL_UINT32(before_us, keyboard->getFrameTimestamp());
+  TEST_ASSERT_GREATER_OR_EQUAL(38, burstBytes);
+  TEST_ASSERT_LESS_THAN(2 * 38, burstBytes);
+  TEST_ASSERT_FALSE(keyboard->isPressed(KEY_SENSOR_B));
+  // Le transfert bloque update(): le temps bus est écoulé au retour
+  TEST_ASSERT_GREATER_THAN(before_us, micros());
+
+  delay(1);
+  before_us = micros();
+  bytes = hostI2cTotalBytes();
+  keyboard->update();
+  TEST_ASSERT_EQUAL_UINT32(burstBytes, hostI2cTotalBytes() - bytes);
+  TEST_ASSERT_EQUAL_UINT32(sequence + 2, keyboard->getFrameSequence());
+  TEST_ASSERT_TRUE(keyboard->isPressed(KEY_SENSOR_B));
+  TEST_ASSERT_EQUAL_UINT32(before_us, keyboard->getOnsetTimestamp(KEY_SENSOR_B));
+}
+
+int main() {
+  hostSerialSetTextOutput(false);
+  hostBoardInit();
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_keys_released);
+  RUN_TEST(test_press_needs_press_threshold);
+  RUN_TEST(test_release_hysteresis);
+  RUN_TEST(test_onset_and_release_masks_once);
+  RUN_TEST(test_thresholds_follow_calibration);
+  RUN_TEST(test_pressure_rises_with_delta);
+  RUN_TEST(test_one_sensor_burst_per_update);
+  return UNITY_END();
+}
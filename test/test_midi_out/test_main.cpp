@@ -0,0 +1,204 @@
+// =================================================================
+// MidiKeyboardOut: seuil et intervalle de pression, budget de ligne, canaux membres MPE
+// =================================================================
+// Les instants sont passés explicitement: T0 est pris après begin(), qui date la ligne libre
+// à micros(). Une pression de 4095 vaut 127; un pas de valeur vaut 32 en pression.
+#include <unity.h>
+#include <vector>
+#include <Arduino.h>
+#include "HostHal.h"
+#include "MidiKeyboardOut.h"
+
+struct SentMessage {
+  uint8_t type;
+  uint8_t channel;
+  uint8_t data1;
+  uint8_t data2;
+};
+
+static std::vector<SentMessage> sent;
+static MidiKeyboardOut* out;
+static uint32_t T0;
+
+static void captureSend(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2) {
+  sent.push_back({ type, channel, data1, data2 });
+}
+
+static size_t countOf(uint8_t type) {
+  size_t n = 0;
+  for (const SentMessage& m : sent) n += (m.type == type);
+  return n;
+}
+
+// Canaux des Note On (vélocité non nulle) émis depuis l'index `from`
+static std::vector<uint8_t> noteOnChannels(size_t from) {
+  std::vector<uint8_t> channels;
+  for (size_t i = from; i < sent.size(); i++) {
+    if (sent[i].type == 0x90 && sent[i].data2 > 0) channels.push_back(sent[i].channel);
+  }
+  return channels;
+}
+
+void setUp(void) {
+  sent.clear();
+  hostAdvanceMicros(100000);
+  out = new MidiKeyboardOut();
+  out->begin(captureSend);
+  T0 = micros() + 10000;  // Ligne libre
+}
+
+void tearDown(void) {
+  delete out;
+}
+
+void test_pressure_threshold(void) {
+  out->onKeyPress(3, 60, T0);
+  // Un seul pas (valeur 1): sous MIDI_OUT_AT_THRESHOLD, rien en attente
+  out->onPressure(3, 32, T0);
+  out->update(T0);
+  TEST_ASSERT_EQUAL_UINT32(0, countOf(0xA0));
+
+  // Deux pas: émis tout de suite, l'intervalle ne s'applique pas à la première valeur
+  out->onPressure(3, 64, T0);
+  out->update(T0);
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(60, sent.back().data1);
+  TEST_ASSERT_EQUAL_UINT8(2, sent.back().data2);
+
+  // Butée haute: émise même à un seul pas de la dernière valeur
+  out->onPressure(3, 4095 - 32, T0 + 30000);
+  out->update(T0 + 30000);
+  out->onPressure(3, 4095, T0 + 60000);
+  out->update(T0 + 60000);
+  TEST_ASSERT_EQUAL_UINT32(3, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(127, sent.back().data2);
+}
+
+void test_per_key_interval_and_merge(void) {
+  out->onKeyPress(5, 62, T0);
+  out->onPressure(5, 640, T0);
+  out->update(T0);
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(0xA0));
+
+  // Deux valeurs dans l'intervalle: la seconde remplace la première
+  out->onPressure(5, 1280, T0 + 1000);
+  out->onPressure(5, 1920, T0 + 2000);
+  TEST_ASSERT_EQUAL_UINT32(1, out->getMergedCount());
+  out->update(T0 + MIDI_OUT_AT_MIN_INTERVAL_US - 1);
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(0xA0));
+
+  out->update(T0 + MIDI_OUT_AT_MIN_INTERVAL_US);
+  TEST_ASSERT_EQUAL_UINT32(2, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(1920 >> 5, sent.back().data2);
+  TEST_ASSERT_EQUAL_UINT32(0, out->getDroppedCount());
+}
+
+void test_pending_pressure_dropped_on_release(void) {
+  out->onKeyPress(5, 62, T0);
+  out->onPressure(5, 640, T0);
+  out->update(T0);
+  out->onPressure(5, 1280, T0 + 1000);
+  out->onKeyRelease(5, T0 + 2000);
+  out->update(T0 + MIDI_OUT_AT_MIN_INTERVAL_US);
+
+  TEST_ASSERT_EQUAL_UINT32(1, out->getDroppedCount());
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(0x90, sent.back().type);
+  TEST_ASSERT_EQUAL_UINT8(0, sent.back().data2);
+}
+
+void test_backlog_holds_off_pressure(void) {
+  // 8 Note On d'un coup: 3 + 7 x 2 octets (running status) = 17 octets en file
+  const uint8_t KEYS = 8;
+  for (uint8_t k = 0; k < KEYS; k++) out->onKeyPress(k, 60 + k, T0);
+  const uint32_t lineFree = T0 + 17 * MIDI_OUT_BYTE_TIME_US;
+  TEST_ASSERT_EQUAL_UINT32(lineFree - T0, out->getMaxBacklog_us());
+  for (uint8_t k = 0; k < KEYS; k++) out->onPressure(k, 2048, T0);
+
+  // Notes non bloquées, pressions retenues tant que la file dépasse MIDI_OUT_MAX_BACKLOG_US
+  out->update(T0);
+  out->update(lineFree - MIDI_OUT_MAX_BACKLOG_US - 1);
+  TEST_ASSERT_EQUAL_UINT32(0, countOf(0xA0));
+
+  // À la limite: une pression (3 octets, changement de statut) et la file repasse au-dessus
+  out->update(lineFree - MIDI_OUT_MAX_BACKLOG_US);
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(60, sent.back().data1);
+
+  // Ligne vidée: les touches suivantes (départ tournant) partent jusqu'à repasser la limite,
+  // soit deux pressions de 2 octets (running status)
+  uint32_t idle = lineFree + 3 * MIDI_OUT_BYTE_TIME_US;
+  out->update(idle);
+  TEST_ASSERT_EQUAL_UINT32(3, countOf(0xA0));
+  TEST_ASSERT_EQUAL_UINT8(61, sent[sent.size() - 2].data1);
+  TEST_ASSERT_EQUAL_UINT8(62, sent.back().data1);
+}
+
+void test_mpe_channels_reused_in_release_order(void) {
+  out->setOutputMode(MidiOutMode::MPE_LOWER_ZONE, T0);
+  for (uint8_t k = 0; k < MPE_MEMBER_CHANNELS; k++) out->onKeyPress(k, 48 + k, T0);
+  std::vector<uint8_t> first = noteOnChannels(0);
+  TEST_ASSERT_EQUAL_UINT32(MPE_MEMBER_CHANNELS, first.size());
+  for (uint8_t k = 0; k < MPE_MEMBER_CHANNELS; k++) TEST_ASSERT_EQUAL_UINT8(MPE_MASTER_CHANNEL + 1 + k, first[k]);
+
+  // Libérés dans l'ordre 9, 5, 13: réattribués dans le même ordre (le moins récemment libéré d'abord)
+  out->onKeyRelease(7, T0 + 1000);
+  out->onKeyRelease(3, T0 + 2000);
+  out->onKeyRelease(11, T0 + 3000);
+  size_t mark = sent.size();
+  out->onKeyPress(20, 70, T0 + 4000);
+  out->onKeyPress(21, 71, T0 + 5000);
+  out->onKeyPress(22, 72, T0 + 6000);
+  std::vector<uint8_t> reused = noteOnChannels(mark);
+  TEST_ASSERT_EQUAL_UINT32(3, reused.size());
+  TEST_ASSERT_EQUAL_UINT8(9, reused[0]);
+  TEST_ASSERT_EQUAL_UINT8(5, reused[1]);
+  TEST_ASSERT_EQUAL_UINT8(13, reused[2]);
+  TEST_ASSERT_EQUAL_UINT32(0, out->getStolenCount());
+}
+
+void test_mpe_steals_oldest_note(void) {
+  out->setOutputMode(MidiOutMode::MPE_LOWER_ZONE, T0);
+  for (uint8_t k = 0; k < MPE_MEMBER_CHANNELS; k++) out->onKeyPress(k, 48 + k, T0 + k);
+  // Touche 0: une pression émise sur son canal, puis une autre en attente, perdue avec la note
+  // (configuration MPE et 15 x (Channel Pressure 0 + Note On): ~28 ms de ligne à vider)
+  out->onPressure(0, 2048, T0 + 100);
+  out->update(T0 + 100000);
+  TEST_ASSERT_EQUAL_UINT8(0xD0, sent.back().type);
+  TEST_ASSERT_EQUAL_UINT8(2, sent.back().channel);
+  out->onPressure(0, 3072, T0 + 101000);
+
+  size_t mark = sent.size();
+  out->onKeyPress(20, 80, T0 + 102000);
+  TEST_ASSERT_EQUAL_UINT32(1, out->getStolenCount());
+  TEST_ASSERT_EQUAL_UINT32(1, out->getDroppedCount());
+
+  // Note off de la plus ancienne (canal 2), remise à zéro de la pression, puis la nouvelle note
+  TEST_ASSERT_EQUAL_UINT32(mark + 3, sent.size());
+  TEST_ASSERT_EQUAL_UINT8(0x90, sent[mark].type);
+  TEST_ASSERT_EQUAL_UINT8(2, sent[mark].channel);
+  TEST_ASSERT_EQUAL_UINT8(48, sent[mark].data1);
+  TEST_ASSERT_EQUAL_UINT8(0, sent[mark].data2);
+  TEST_ASSERT_EQUAL_UINT8(0xD0, sent[mark + 1].type);
+  TEST_ASSERT_EQUAL_UINT8(2, sent[mark + 1].channel);
+  TEST_ASSERT_EQUAL_UINT8(0x90, sent[mark + 2].type);
+  TEST_ASSERT_EQUAL_UINT8(2, sent[mark + 2].channel);
+  TEST_ASSERT_EQUAL_UINT8(80, sent[mark + 2].data1);
+
+  // La note suivante vole la deuxième plus ancienne (canal 3)
+  out->onKeyPress(21, 81, T0 + 103000);
+  TEST_ASSERT_EQUAL_UINT32(2, out->getStolenCount());
+  TEST_ASSERT_EQUAL_UINT8(3, noteOnChannels(mark + 3).back());
+}
+
+int main() {
+  hostSerialSetTextOutput(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_pressure_threshold);
+  RUN_TEST(test_per_key_interval_and_merge);
+  RUN_TEST(test_pending_pressure_dropped_on_release);
+  RUN_TEST(test_backlog_holds_off_pressure);
+  RUN_TEST(test_mpe_channels_reused_in_release_order);
+  RUN_TEST(test_mpe_steals_oldest_note);
+  return UNITY_END();
+}
@@ -0,0 +1,178 @@
+// =================================================================
+// Chaîne de pression: virgule fixe contre flottant, table contre courbe exacte
+// =================================================================
+// Les deux implémentations reçoivent les mêmes chutes (rampes, ondulations bruitées, échelons
+// plus rapides que le slew, passages sous la zone morte et au-delà de la chute max) pour
+// plusieurs formes de courbe et zones mortes. Une troisième chaîne, écrite ici, reproduit
+// l'ancien calcul par touche (powf et historique flottant) comme référence des tables et de
+// la moyenne à somme glissante.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "PressureChain.h"
+
+static const float SHAPES[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+static const uint16_t DEADZONES[] = { 0, 40, 120, 250 };
+static const uint16_t MAX_DELTAS[] = { 150, 400, 900 };
+static const uint32_t FRAMES_PER_RUN = 4000;
+
+// Chaîne d'origine: courbe évaluée à chaque trame, moyenne sur historique flottant
+class ReferenceChain {
+public:
+  ReferenceChain(float shape) : _shape(shape) { reset(); }
+
+  void reset() {
+    _slewed = 0.0f;
+    _index = 0;
+    for (int j = 0; j < AFTERTOUCH_SMOOTHING_WINDOW_SIZE; j++) _history[j] = 0.0f;
+  }
+
+  uint16_t process(bool pressed, uint16_t delta, uint16_t pressDelta, uint16_t maxDelta) {
+    float target = 0.0f;
+    if (pressed) {
+      float x = 0.0f;
+      if (maxDelta > pressDelta) x = (float)((delta > pressDelta) ? (delta - pressDelta) : 0) / (float)(maxDelta - pressDelta);
+      if (x > 1.0f) x = 1.0f;
+      target = evaluateResponseCurve(x, _shape, AFTERTOUCH_CURVE_EXP_INTENSITY, AFTERTOUCH_CURVE_SIG_INTENSITY) *
+               (float)CV_OUTPUT_RESOLUTION;
+    }
+    float diff = target - _slewed;
+    if (diff > AFTERTOUCH_SLEW_RATE_LIMIT) _slewed += AFTERTOUCH_SLEW_RATE_LIMIT;
+    else if (diff < -AFTERTOUCH_SLEW_RATE_LIMIT) _slewed -= AFTERTOUCH_SLEW_RATE_LIMIT;
+    else _slewed = target;
+
+    _history[_index] = _slewed;
+    _index = (_index + 1) % AFTERTOUCH_SMOOTHING_WINDOW_SIZE;
+    float sum = 0.0f;
+    for (int j = 0; j < AFTERTOUCH_SMOOTHING_WINDOW_SIZE; j++) sum += _history[j];
+    return (uint16_t)(sum / (float)AFTERTOUCH_SMOOTHING_WINDOW_SIZE);
+  }
+
+private:
+  float _shape;
+  float _slewed;
+  float _history[AFTERTOUCH_SMOOTHING_WINDOW_SIZE];
+  uint8_t _index;
+};
+
+static uint32_t randomState;
+
+static uint32_t nextRandom(uint32_t range) {
+  randomState = randomState * 1664525UL + 1013904223UL;
+  return (randomState >> 8) % range;
+}
+
+// Chute simulée à la trame n d'un appui: attaque, ondulation bruitée, échelons, relâchement
+static uint16_t scriptedDelta(uint32_t n, uint16_t pressDelta, uint16_t maxDelta) {
+  uint32_t phase = n % 400;
+  int32_t span = (int32_t)maxDelta - pressDelta;
+  int32_t value;
+  if (phase < 60) {
+    value = pressDelta + span * (int32_t)phase / 50;                      // Rampe jusqu'au-delà du max
+  } else if (phase < 250) {
+    value = pressDelta + span / 2 + (int32_t)((phase % 40) - 20) * span / 40 + (int32_t)nextRandom(9) - 4;
+  } else if (phase < 330) {
+    value = (phase / 10) % 2 ? maxDelta + 20 : pressDelta - 10;            // Échelons
+  } else {
+    value = pressDelta + span * (int32_t)(400 - phase) / 80;               // Descente
+  }
+  if (value < 0) value = 0;
+  return (uint16_t)value;
+}
+
+struct Comparison {
+  uint32_t samples;
+  uint32_t fixedVsFloatMax;
+  uint32_t fixedVsFloatCount;   // Trames où les deux chemins diffèrent
+  uint32_t fixedVsReferenceMax;
+  uint32_t floatVsReferenceMax;
+};
+
+static uint32_t absDiff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+
+static Comparison compareChains() {
+  Comparison result = {};
+  uint16_t curve[RESPONSE_CURVE_LUT_SIZE + 1];
+  randomState = 0x2468ACE;
+
+  for (float shape : SHAPES) {
+    buildResponseCurve(curve, shape, AFTERTOUCH_CURVE_EXP_INTENSITY, AFTERTOUCH_CURVE_SIG_INTENSITY);
+    for (uint16_t deadzone : DEADZONES) {
+      for (uint16_t maxDelta : MAX_DELTAS) {
+        PressureChainFixed fixedChain;
+        PressureChainFloat floatChain;
+        ReferenceChain reference(shape);
+        // Chute au seuil d'appui, comme pressDeltaStart
+        uint16_t pressDelta = maxDelta * PRESS_THRESHOLD_PERCENT + 1 + deadzone;
+        for (uint32_t n = 0; n < FRAMES_PER_RUN; n++) {
+          // Relâchement forcé toutes les 400 trames, comme la remise à zéro du clavier
+          bool pressed = (n % 400) != 399;
+          if (!pressed) {
+            fixedChain.reset();
+            floatChain.reset();
+            reference.reset();
+          }
+          uint16_t delta = scriptedDelta(n, pressDelta, maxDelta);
+          uint16_t f = fixedChain.process(pressed, delta, pressDelta, maxDelta, curve);
+          uint16_t g = floatChain.process(pressed, delta, pressDelta, maxDelta, curve);
+          uint16_t r = reference.process(pressed, delta, pressDelta, maxDelta);
+
+          uint32_t d = absDiff(f, g);
+          if (d > result.fixedVsFloatMax) result.fixedVsFloatMax = d;
+          if (d) result.fixedVsFloatCount++;
+          if (absDiff(f, r) > result.fixedVsReferenceMax) result.fixedVsReferenceMax = absDiff(f, r);
+          if (absDiff(g, r) > result.floatVsReferenceMax) result.floatVsReferenceMax = absDiff(g, r);
+          result.samples++;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fixed_matches_float_within_one_lsb(void) {
+  Comparison c = compareChains();
+  char message[160];
+  snprintf(message, sizeof(message), "%u trames: fixe/flottant max %u LSB (%u trames differentes), "
+           "fixe/reference max %u, flottant/reference max %u", c.samples, c.fixedVsFloatMax,
+           c.fixedVsFloatCount, c.fixedVsReferenceMax, c.floatVsReferenceMax);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_OR_EQUAL(1, c.fixedVsFloatMax);
+}
+
+void test_chains_match_per_frame_powf_reference(void) {
+  // Table (004) et moyenne à somme glissante (007) contre le calcul d'origine
+  Comparison c = compareChains();
+  TEST_ASSERT_LESS_OR_EQUAL(1, c.floatVsReferenceMax);
+  TEST_ASSERT_LESS_OR_EQUAL(1, c.fixedVsReferenceMax);
+}
+
+void test_lut_matches_exact_curve(void) {
+  uint16_t curve[RESPONSE_CURVE_LUT_SIZE + 1];
+  for (float shape : SHAPES) {
+    buildResponseCurve(curve, shape, AFTERTOUCH_CURVE_EXP_INTENSITY, AFTERTOUCH_CURVE_SIG_INTENSITY);
+    float maxError = 0.0f;
+    for (int32_t x = 0; x <= 32768; x++) {
+      float exact = evaluateResponseCurve(x / 32768.0f, shape, AFTERTOUCH_CURVE_EXP_INTENSITY,
+                                          AFTERTOUCH_CURVE_SIG_INTENSITY) * CV_OUTPUT_RESOLUTION;
+      float table = lookupResponseCurve(curve, x) * (float)CV_OUTPUT_RESOLUTION / 32768.0f;
+      float error = exact > table ? exact - table : table - exact;
+      if (error > maxError) maxError = error;
+    }
+    char message[80];
+    snprintf(message, sizeof(message), "forme %.2f: ecart table/courbe max %.3f LSB", shape, maxError);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(maxError <= 1.0f, message);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_matches_float_within_one_lsb);
+  RUN_TEST(test_chains_match_per_frame_powf_reference);
+  RUN_TEST(test_lut_matches_exact_curve);
+  return UNITY_END();
+}
@@ -0,0 +1,75 @@
+// =================================================================
+// PulseOutputs: fronts posés par le timer one-shot, y compris au-delà de la plage du compteur
+// =================================================================
+// Le timer hôte compte en µs sur 16 bits (65 535 µs au plus par armement), comme un canal AGT
+// ou GPT 16 bits sur cible: une échéance plus lointaine doit être atteinte en plusieurs armements.
+#include <unity.h>
+#include <Arduino.h>
+#include "HostHal.h"
+#include "HardwareConfig.h"
+#include "PulseOutputs.h"
+
+static PulseOutputs outputs;
+
+// Avance jusqu'à la veille de l'échéance, vérifie le niveau, puis franchit l'échéance
+static void expectEdgeAt(uint8_t pin, uint32_t at_us, int levelAfter) {
+  hostAdvanceMicros((uint32_t)(at_us - 1 - micros()));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(!levelAfter, hostGetPinOutput(pin), "front en avance");
+  hostAdvanceMicros(1);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(levelAfter, hostGetPinOutput(pin), "front en retard ou perdu");
+}
+
+void setUp(void) {
+  outputs.clear();
+  hostAdvanceMicros(1000);
+}
+
+void tearDown(void) {}
+
+void test_begin(void) {
+  TEST_ASSERT_TRUE(outputs.begin());
+}
+
+void test_trigger_width(void) {
+  uint32_t now = micros();
+  outputs.schedulePulse(PulseOutputs::TRIGGER, now, 5000);
+  TEST_ASSERT_EQUAL_INT(HIGH, hostGetPinOutput(PIN_TRIGGER));
+  expectEdgeAt(PIN_TRIGGER, now + 5000, LOW);
+  TEST_ASSERT_FALSE(outputs.isPending(PulseOutputs::TRIGGER));
+}
+
+void test_gate_longer_than_counter(void) {
+  uint32_t now = micros();
+  outputs.schedulePulse(PulseOutputs::GATE, now, 200000);
+  expectEdgeAt(PIN_GATE, now + 200000, LOW);
+}
+
+void test_gate_multiple_of_counter_range(void) {
+  // 65 536 µs et ses multiples tronqués à 16 bits donneraient une période nulle
+  uint32_t now = micros();
+  outputs.schedulePulse(PulseOutputs::GATE, now, 65536);
+  expectEdgeAt(PIN_GATE, now + 65536, LOW);
+
+  now = micros();
+  outputs.schedulePulse(PulseOutputs::GATE, now, 4 * 65536);
+  expectEdgeAt(PIN_GATE, now + 4 * 65536, LOW);
+}
+
+void test_delayed_rise_beyond_counter(void) {
+  uint32_t now = micros();
+  outputs.schedulePulse(PulseOutputs::GATE, now + 131072, 70000);
+  TEST_ASSERT_EQUAL_INT(LOW, hostGetPinOutput(PIN_GATE));
+  expectEdgeAt(PIN_GATE, now + 131072, HIGH);
+  expectEdgeAt(PIN_GATE, now + 131072 + 70000, LOW);
+}
+
+int main() {
+  hostSerialSetTextOutput(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_begin);
+  RUN_TEST(test_trigger_width);
+  RUN_TEST(test_gate_longer_than_counter);
+  RUN_TEST(test_gate_multiple_of_counter_range);
+  RUN_TEST(test_delayed_rise_beyond_counter);
+  return UNITY_END();
+}
@@ -0,0 +1,48 @@
+// =================================================================
+// Non-régression: rejeu de scenario.txt, trace comparée à expected.trace
+// =================================================================
+// Le port série porte aussi les commandes du profileur: en plus de la trace (valeurs 0x70/0x72
+// bien appliquées), le texte émis ne doit contenir que le dump demandé hors running status.
+#include <unity.h>
+#include <string>
+#include "HostHal.h"
+#include "HostScenario.h"
+
+// Le scénario et sa trace sont à côté de ce fichier
+static std::string testDir() {
+  std::string file = __FILE__;
+  return file.substr(0, file.find_last_of("/\\") + 1);
+}
+
+static int countOccurrences(const std::string& text, const char* pattern) {
+  int count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) count++;
+  return count;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_trace_matches_expected(void) {
+  std::string dir = testDir();
+  char message[600];
+  hostSerialCaptureText(true);
+  bool match = hostScenarioCheck((dir + "scenario.txt").c_str(), (dir + "expected.trace").c_str(),
+                                 message, sizeof(message));
+
+  std::string text;
+  char chunk[256];
+  size_t n;
+  while ((n = hostSerialTakeText(chunk, sizeof(chunk))) > 0) text.append(chunk, n);
+  hostSerialCaptureText(false);
+
+  TEST_ASSERT_TRUE_MESSAGE(match, message);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, countOccurrences(text, "--- Profil loop"),
+                                "dump du profileur déclenché par une donnée sous running status");
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_trace_matches_expected);
+  return UNITY_END();
+}
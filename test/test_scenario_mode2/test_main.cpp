@@ -0,0 +1,29 @@
+// =================================================================
+// Non-régression: rejeu de scenario.txt, trace comparée à expected.trace
+// =================================================================
+#include <unity.h>
+#include <string>
+#include "HostScenario.h"
+
+// Le scénario et sa trace sont à côté de ce fichier
+static std::string testDir() {
+  std::string file = __FILE__;
+  return file.substr(0, file.find_last_of("/\\") + 1);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_trace_matches_expected(void) {
+  std::string dir = testDir();
+  char message[600];
+  bool match = hostScenarioCheck((dir + "scenario.txt").c_str(), (dir + "expected.trace").c_str(),
+                                 message, sizeof(message));
+  TEST_ASSERT_TRUE_MESSAGE(match, message);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_trace_matches_expected);
+  return UNITY_END();
+}
@@ -0,0 +1,88 @@
+// =================================================================
+// TempoGrid: échéances exactes sur 10 000 pas, changements de période, rebouclage de micros()
+// =================================================================
+// Tempo fixe: la n-ième échéance vaut exactement start + floor(n x numérateur / diviseur), soit
+// une erreur cumulée de 0 µs par rapport à la grille entière et de moins d'1 µs par rapport au
+// temps rationnel exact. Chaque setPeriod() perd la phase sous-µs en cours: après k changements
+// la grille est en retard de moins de k + 1 µs sur le temps exact, jamais en avance.
+#include <unity.h>
+#include <stdio.h>
+#include "TempoGrid.h"
+
+static const uint32_t STEPS = 10000;
+static const uint32_t BEAT_US = 60000000UL;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void checkExactGrid(uint16_t bpm, uint32_t start_us) {
+  TempoGrid grid;
+  grid.setPeriod(BEAT_US, bpm);
+  grid.restart(start_us);
+  for (uint32_t n = 1; n <= STEPS; n++) {
+    uint32_t expected = start_us + (uint32_t)((uint64_t)n * BEAT_US / bpm);
+    if (grid.next() != expected) {
+      char message[96];
+      snprintf(message, sizeof(message), "%u BPM, pas %u: %u au lieu de %u", bpm, n, grid.next(), expected);
+      TEST_FAIL_MESSAGE(message);
+    }
+    grid.advance();
+  }
+}
+
+void test_fixed_tempo_zero_cumulative_error(void) {
+  static const uint16_t tempos[] = { 5, 120, 137, 451, 899, 900 };
+  for (uint16_t bpm : tempos) checkExactGrid(bpm, 1000);
+}
+
+void test_micros_wraparound(void) {
+  // 10 000 pas à 137 BPM couvrent 4380 s: le compteur 32 bits reboucle en cours de route
+  checkExactGrid(137, 0xFFF00000UL);
+}
+
+void test_tempo_changes_bounded_error(void) {
+  static const uint16_t tempos[] = { 120, 137, 451, 900, 61, 333, 97 };
+  const uint32_t start_us = 5000;
+  TempoGrid grid;
+  grid.setPeriod(BEAT_US, tempos[0]);
+  grid.restart(start_us);
+
+  // Temps exact de l'échéance courante: début du segment (échéance où le tempo a changé) + j x période
+  double segmentStart_us = start_us + (double)BEAT_US / tempos[0];
+  uint32_t segmentStep = 1;
+  uint8_t changes = 0;
+  double worstLate_us = 0.0;
+  uint64_t elapsed_us = 0;  // Déroulé: la durée totale dépasse le rebouclage 32 bits
+  uint32_t previous_us = start_us;
+
+  for (uint32_t n = 1; n <= STEPS; n++) {
+    uint16_t bpm = tempos[changes];
+    double exact_us = segmentStart_us + (double)((uint64_t)(n - segmentStep) * BEAT_US) / bpm;
+    elapsed_us += grid.next() - previous_us;
+    previous_us = grid.next();
+    double error_us = (double)elapsed_us - (exact_us - start_us);
+    TEST_ASSERT_TRUE_MESSAGE(error_us <= 0.0, "grille en avance sur le temps exact");
+    TEST_ASSERT_TRUE_MESSAGE(error_us > -(double)(changes + 1), "retard au-delà d'1 us par changement");
+    if (-error_us > worstLate_us) worstLate_us = -error_us;
+
+    // Nouveau tempo tous les 1500 pas, appliqué à partir de l'échéance suivante
+    if (n % 1500 == 0 && changes + 1 < (uint8_t)(sizeof(tempos) / sizeof(tempos[0]))) {
+      changes++;
+      grid.setPeriod(BEAT_US, tempos[changes]);
+      segmentStart_us = exact_us + (double)BEAT_US / tempos[changes];
+      segmentStep = n + 1;
+    }
+    grid.advance();
+  }
+  char message[80];
+  snprintf(message, sizeof(message), "%u changements de tempo: retard max %.3f us", changes, worstLate_us);
+  TEST_MESSAGE(message);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_tempo_zero_cumulative_error);
+  RUN_TEST(test_micros_wraparound);
+  RUN_TEST(test_tempo_changes_bounded_error);
+  return UNITY_END();
+}